@@ -13,8 +13,8 @@
 #include <thread>
 using std::ref;
 using std::cref;
-#include <FL/Fl.H>
 #include "backprojection.h"
+#include "simulation.h"
 
 
 
@@ -28,7 +28,7 @@ const string Backprojection::FILE_PREAMBLE{ "BACKPROJECTION_FILE_PREAMBLE" };
 void Backprojection::ReconstructImageColumn(	
 										 size_t& current_angle_index, mutex& current_angle_index_mutex, 
 										 Backprojection& image, mutex& image_mutex, 
-										 Fl_Progress_Window* progress, mutex& progress_mutex, 
+										 ProgressToken* progress_token, 
 										 const FilteredProjections& projections ){
 
 	const size_t number_of_distances = image.size().r;			// number of distances
@@ -46,12 +46,12 @@ void Backprojection::ReconstructImageColumn(
 
 		if( angle_index >= number_of_angles ) break;
 
-		if( progress != nullptr ){
-			progress_mutex.lock();
-			progress->ChangeLineText( 1, "Backprojecting projection " 
-																	 + ConvertToString( angle_index + 1 ) + " of " 
-																	 + ConvertToString( number_of_angles ) );
-			progress_mutex.unlock();
+		if( progress_token != nullptr ){
+			if( progress_token->stop_requested() ) break;
+			
+			progress_token->SetLine( 1, "Backprojecting projection " 
+																	+ ConvertToString( angle_index + 1 ) + " of " 
+																	+ ConvertToString( number_of_angles ) );
 		}
 
 		// current angle value
@@ -84,14 +84,13 @@ void Backprojection::ReconstructImageColumn(
 			}
 		}
 
-		progress_mutex.lock();
-		Fl::check(); 
-		progress_mutex.unlock();
+		if( progress_token != nullptr ) 
+			progress_token->Advance();
 	}
 }
 
 
-Backprojection::Backprojection( const FilteredProjections& projections, Fl_Progress_Window* progress )
+Backprojection::Backprojection( const FilteredProjections& projections, ProgressToken* progress_token )
 {
 
 	const double distance_range =  static_cast<double>( projections.size().r - 1 ) * projections.resolution().r ;
@@ -108,13 +107,16 @@ Backprojection::Backprojection( const FilteredProjections& projections, Fl_Progr
 
 
 	size_t current_angle_index = 0; 
-	mutex current_angle_index_mutex, imageMutex, progressMutex;
+	mutex current_angle_index_mutex, imageMutex;
+
+	if( progress_token != nullptr ) 
+		progress_token->SetTotal( projections.size().c );
 
 	// computation in threads
 	vector<std::thread> threads;
 
-	for( size_t thread_index = 0; thread_index < std::thread::hardware_concurrency(); thread_index++ ){
-		threads.emplace_back( ReconstructImageColumn, ref( current_angle_index ), ref( current_angle_index_mutex ), ref( *this ), ref( imageMutex ), progress, ref( progressMutex ), projections );
+	for( size_t thread_index = 0; thread_index < GetNumberOfThreads(); thread_index++ ){
+		threads.emplace_back( ReconstructImageColumn, ref( current_angle_index ), ref( current_angle_index_mutex ), ref( *this ), ref( imageMutex ), progress_token, projections );
 	}
 
 	for( std::thread& currentThread : threads ) currentThread.join();
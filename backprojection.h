@@ -14,7 +14,7 @@
 
 #include "dataGrid.h"
 #include "filteredProjections.h"
-#include "fl_ProgressWindow.h"
+#include "progressToken.h"
 
 
 
@@ -39,9 +39,9 @@ class Backprojection : private DataGrid<> {
 	/*!
 	 * @brief constructor
 	 * @param filtered_projections filtered projections 
-	 * @param progress_window FL window to track progress
+	 * @param progress_token token to report progress and to stop. The image is incomplete when stop was requested
 	*/
-	Backprojection( const FilteredProjections& filtered_projections, Fl_Progress_Window* progress_window = nullptr );
+	Backprojection( const FilteredProjections& filtered_projections, ProgressToken* progress_token = nullptr );
 
 	/*!
 	 * @brief constructor from serialized data
@@ -73,13 +73,12 @@ class Backprojection : private DataGrid<> {
 	 * @param current_angle_index_mutex mutex for x-index
 	 * @param reconstructed_image reference to image
 	 * @param reconstructed_image_mutex mutex for image
-	 * @param progress_window progress window
-	 * @param progress_window_mutex mutex for progress
+	 * @param progress_token token to report progress and to stop
 	 * @param filtered_projections projections
 	*/
 	static void ReconstructImageColumn(	size_t& current_angle_index, mutex& current_angle_index_mutex,
 										Backprojection& reconstructed_image,	mutex& reconstructed_image_mutex, 
-										Fl_Progress_Window* progress_window,	mutex& progress_window_mutex, 
+										ProgressToken* progress_token, 
 										const FilteredProjections& filtered_projections );
 
 };
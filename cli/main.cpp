@@ -0,0 +1,368 @@
+/*********************************************************************
+ * @file   main.cpp
+ * @brief  main file of the command line scan runner
+ * @details records a slice, filters and backprojects it without graphical interface. Parameter sweeps run many slices
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+
+#include "generel.h"
+#include "programState.h"
+#include "persistingObject.h"
+#include "serialization.h"
+#include "coordinateSystemTree.h"
+#include "simulation.h"
+#include "model.h"
+#include "projections.h"
+#include "fanBeamProjections.h"
+#include "filteredProjections.h"
+#include "backprojection.h"
+#include "tomography.h"
+#include "scanConfiguration.h"
+#include "parameterSweep.h"
+#include "progressToken.h"
+
+
+
+/*********************************************************************
+  Definitions
+*********************************************************************/
+
+constexpr double report_interval_s = 5.;	/*!< interval to print progress*/
+
+static std::atomic<ProgressToken*> running_token{ nullptr };	/*!< token of running computation for interrupt handling*/
+
+
+/*!
+ * @brief print usage
+*/
+void PrintUsage( void ){
+	std::cout << 
+		"Usage: ct-simulator-cli --model <file> [options]\n"
+		"\n"
+		"Records a slice of the centered model, filters and backprojects it.\n"
+		"\n"
+		"Input:\n"
+		"  --model <file>                   serialized model\n"
+		"  --tube <file>                    serialized x-ray tube properties\n"
+		"  --projections-properties <file>  serialized projections properties\n"
+		"  --detector <file>                serialized physical detector properties\n"
+		"  --tomography <file>              serialized tomography properties\n"
+		"  --config <file>                  text file with lines \"name = value\". Applied after serialized properties\n"
+		"  --set <name>=<value>             set a single parameter. Applied last\n"
+		"  --threads <n>                    amount of threads. Hardware concurrency when omitted\n"
+		"  --acquisition <type>             parallel, fan-beam or short-scan. Parallel fills the projections grid while recording.\n"
+		"                                   Fan-beam records all pixel of a full rotation and rebins when filtering.\n"
+		"                                   Short-scan records half a rotation plus the fan angle with parker weights\n"
+		"\n"
+		"Output:\n"
+		"  --projections <file>             recorded projections\n"
+		"  --filtered-projections <file>    filtered projections\n"
+		"  --backprojection <file>          reconstructed image\n"
+		"\n"
+		"Sweep:\n"
+		"  --sweep <file>                   text file with lines \"name = value, value, ...\" and \"[run]\" sections.\n"
+		"                                   Runs each parameter combination instead of a single slice\n"
+		"  --output-directory <directory>   directory for results and manifest of sweep\n"
+		"  --parallel-runs <n>              amount of runs at the same time. Threads are split among them\n"
+		"\n"
+		"Parameters:\n ";
+	
+	for( const string& parameter_name : ScanConfiguration::parameter_names ) std::cout << " " << parameter_name;
+	
+	std::cout << "\n\nAn interrupt stops the recording. Recording again with the same parameters resumes it.\n";
+}
+
+/*!
+ * @brief load serialized object
+ * @tparam C class of object
+ * @param file_path path to file
+ * @param object object to assign loaded data to
+ * @return true at success
+*/
+template< class C >
+bool Import( const path file_path, C& object ){
+	PersistingObject<C> loaded_object{ C{}, file_path, true };
+	if( !loaded_object.was_loaded() ) return false;
+	
+	object = loaded_object;
+	return true;
+}
+
+/*!
+ * @brief store object serialized
+ * @tparam C class of object
+ * @param object object to store
+ * @param file_path path to file
+ * @return true at success
+*/
+template< class C >
+bool Export( const C& object, const path file_path ){
+	vector<char> binary_data;
+	SerializeBuildIn<string>( C::FILE_PREAMBLE, binary_data );
+	object.Serialize( binary_data );
+	return ExportSerialized( file_path, binary_data );
+}
+
+/*!
+ * @brief run a computation and print its progress
+ * @tparam F type of computation
+ * @param progress_token token the computation reports to
+ * @param computation computation to run
+ * @return result of computation
+*/
+template< typename F >
+auto RunWithProgress( ProgressToken& progress_token, F&& computation ) -> decltype( computation() ){
+
+	std::atomic<bool> is_finished{ false };
+
+	// print progress on its own thread
+	std::thread reporter{ [ & ]( void ){
+		auto last_report = std::chrono::steady_clock::now();
+		size_t reported_revision = progress_token.revision();
+
+		while( !is_finished.load() ){
+			std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+			if( std::chrono::duration<double>( std::chrono::steady_clock::now() - last_report ).count() < report_interval_s ) continue;
+			last_report = std::chrono::steady_clock::now();
+
+			const size_t revision = progress_token.revision();
+			if( revision == reported_revision ) continue;
+			reported_revision = revision;
+
+			const size_t total_steps = progress_token.total_steps();
+			const size_t percentage = total_steps > 0 ? std::min( progress_token.completed_steps() * 100 / total_steps, static_cast<size_t>( 100 ) ) : 0;
+			std::cout << percentage << "%";
+			for( const string& line : progress_token.lines() ) if( !line.empty() ) std::cout << " " << line;
+			std::cout << std::endl;
+		}
+	} };
+
+	running_token.store( &progress_token );
+	auto result = computation();
+	running_token.store( nullptr );
+
+	is_finished.store( true );
+	reporter.join();
+
+	return result;
+}
+
+/*!
+ * @brief stop running computation on interrupt
+ * @param signal signal number
+*/
+void HandleInterrupt( [[maybe_unused]] int signal ){
+	ProgressToken* const progress_token = running_token.load();
+	if( progress_token != nullptr ) progress_token->RequestStop();
+}
+
+
+int main( int argc, char** argv ){
+
+	path model_path;
+	path projections_path, filtered_projections_path, backprojection_path;
+	path sweep_path, output_directory;
+	size_t number_of_parallel_runs = 0;
+	bool is_fan_beam = false;
+	bool is_short_scan = false;
+	ScanConfiguration configuration;
+	vector<string> parameter_settings;
+
+	// parse arguments
+	for( int argument_index = 1; argument_index < argc; argument_index++ ){
+		
+		const string argument{ argv[ argument_index ] };
+
+		if( argument == "--help" || argument == "-h" ){
+			PrintUsage();
+			return 0;
+		}
+
+		if( argument_index + 1 >= argc ){
+			std::cerr << "Missing value for " << argument << "\n";
+			return 1;
+		}
+		const string value{ argv[ ++argument_index ] };
+
+		bool is_valid = true;
+
+		if( argument == "--model" ) model_path = value;
+		else if( argument == "--tube" ) is_valid = Import( value, configuration.tube_properties );
+		else if( argument == "--projections-properties" ) is_valid = Import( value, configuration.projections_properties );
+		else if( argument == "--detector" ) is_valid = Import( value, configuration.detector_properties );
+		else if( argument == "--tomography" ) is_valid = Import( value, configuration.tomography_properties );
+		else if( argument == "--config" ){
+			vector<string> invalid_lines;
+			is_valid = configuration.Load( value, &invalid_lines );
+			for( const string& invalid_line : invalid_lines ) std::cerr << "Invalid line: " << invalid_line << "\n";
+		}
+		else if( argument == "--set" ) parameter_settings.push_back( value );
+		else if( argument == "--threads" ){
+			try{ SetNumberOfThreads( static_cast<size_t>( std::stoul( value ) ) ); }
+			catch( const std::exception& ){ is_valid = false; }
+		}
+		else if( argument == "--acquisition" ){
+			is_valid = value == "parallel" || value == "fan-beam" || value == "short-scan";
+			is_fan_beam = value == "fan-beam" || value == "short-scan";
+			is_short_scan = value == "short-scan";
+		}
+		else if( argument == "--projections" ) projections_path = value;
+		else if( argument == "--filtered-projections" ) filtered_projections_path = value;
+		else if( argument == "--backprojection" ) backprojection_path = value;
+		else if( argument == "--sweep" ) sweep_path = value;
+		else if( argument == "--output-directory" ) output_directory = value;
+		else if( argument == "--parallel-runs" ){
+			try{ number_of_parallel_runs = static_cast<size_t>( std::stoul( value ) ); }
+			catch( const std::exception& ){ is_valid = false; }
+		}
+		else{
+			std::cerr << "Unknown option " << argument << "\n";
+			return 1;
+		}
+
+		if( !is_valid ){
+			std::cerr << "Invalid value for " << argument << ": " << value << "\n";
+			return 1;
+		}
+	}
+
+	for( const string& parameter_setting : parameter_settings ){
+		const size_t separator = parameter_setting.find( '=' );
+		if( separator == string::npos || !configuration.Set( parameter_setting.substr( 0, separator ), parameter_setting.substr( separator + 1 ) ) ){
+			std::cerr << "Invalid parameter " << parameter_setting << "\n";
+			return 1;
+		}
+	}
+
+	const bool is_sweep = !sweep_path.empty();
+	if( model_path.empty() || ( is_sweep && output_directory.empty() ) || 
+			( !is_sweep && projections_path.empty() && filtered_projections_path.empty() && backprojection_path.empty() ) ){
+		PrintUsage();
+		return 1;
+	}
+
+	// create instance of program state for cached tables
+	[[maybe_unused]] volatile ProgramState& program_state = PROGRAM_STATE();
+
+	PersistingObject<Model> model{ Model{}, model_path, true };
+	if( !model.was_loaded() ){
+		std::cerr << "Could not load model " << model_path << "\n";
+		return 2;
+	}
+
+	// center model like the graphical interface
+	const Tuple3D center = PrimitiveVector3{ model.size() } / -2.;
+	model.coordinate_system()->SetPrimitive( PrimitiveCoordinateSystem{ PrimitiveVector3{ center }, PrimitiveVector3{ 1, 0, 0 }, PrimitiveVector3{ 0, 1, 0 }, PrimitiveVector3{ 0, 0, 1 } } );
+
+	std::signal( SIGINT, HandleInterrupt );
+	std::signal( SIGTERM, HandleInterrupt );
+
+	if( is_sweep ){
+		ParameterSweep sweep{ configuration };
+		vector<string> invalid_lines;
+		if( !sweep.Load( sweep_path, &invalid_lines ) ){
+			std::cerr << "Could not load sweep " << sweep_path << "\n";
+			for( const string& invalid_line : invalid_lines ) std::cerr << "Invalid line: " << invalid_line << "\n";
+			return 1;
+		}
+
+		std::cout << "Sweeping " << sweep.runs().size() << " runs with " << sweep.number_of_acquisitions() << " recordings and " << 
+			sweep.number_of_transports() << " primary transports" << std::endl;
+
+		ProgressToken sweep_token;
+		const bool all_done = RunWithProgress( sweep_token, [ & ]( void ){
+			return sweep.Execute( model, output_directory, number_of_parallel_runs, &sweep_token ); } );
+
+		std::cout << "Manifest written to " << ( output_directory / ParameterSweep::manifest_file_name ).string() << std::endl;
+		return all_done ? 0 : 2;
+	}
+
+	// the gantry depends on the simulation quality
+	TomographyProperties& tomography_properties = configuration.tomography_properties;
+	simulation_properties = SimulationProperties{ tomography_properties.simulation_quality };
+	Gantry gantry = configuration.CreateGantry( GetCoordinateSystemTree().AddSystem( "Gantry system" ) );
+
+	tomography_properties.mean_energy_of_tube = gantry.tube().GetMeanEnergy();
+	tomography_properties.filter_active = gantry.tube().properties().has_filter_;
+
+	// a fan-beam acquisition records a full rotation. A short scan records the frames to fill the grid
+	const size_t number_of_frames = is_fan_beam && !is_short_scan ? 2 * configuration.projections_properties.number_of_projections() : 
+																																	configuration.projections_properties.number_of_frames_to_fill();
+	
+	std::cout << "Recording " << number_of_frames << " frames with " << GetNumberOfThreads() << " threads" << std::endl;
+
+	Tomography tomography{ tomography_properties };
+	ProgressToken recording_token;
+	optional<Projections> projections;
+	optional<FanBeamProjections> fan_beam_projections;
+	
+	if( is_short_scan )
+		fan_beam_projections = RunWithProgress( recording_token, [ & ]( void ){
+			return tomography.RecordShortScan( configuration.projections_properties, gantry, model, configuration.z_position, &recording_token ); } );
+	else if( is_fan_beam )
+		fan_beam_projections = RunWithProgress( recording_token, [ & ]( void ){
+			return tomography.RecordFanBeam( configuration.projections_properties, gantry, model, configuration.z_position, number_of_frames, &recording_token ); } );
+	else
+		projections = RunWithProgress( recording_token, [ & ]( void ){
+			return tomography.RecordSlice( configuration.projections_properties, gantry, model, configuration.z_position, &recording_token ); } );
+	
+	if( !projections.has_value() && !fan_beam_projections.has_value() ){
+		std::cerr << "Recording stopped\n";
+		return 2;
+	}
+
+	if( !projections_path.empty() && 
+			!( is_fan_beam ? Export( fan_beam_projections.value(), projections_path ) : Export( projections.value(), projections_path ) ) ){
+		std::cerr << "Could not write " << projections_path << "\n";
+		return 2;
+	}
+
+	if( filtered_projections_path.empty() && backprojection_path.empty() ) return 0;
+
+	std::cout << "Reconstructing" << std::endl;
+
+	ProgressToken reconstruction_token;
+	const FilteredProjections filtered_projections = RunWithProgress( reconstruction_token, [ & ]( void ){
+		return is_fan_beam ? FilteredProjections{ fan_beam_projections.value(), configuration.filter_type, &reconstruction_token } :
+												 FilteredProjections{ projections.value(), configuration.filter_type, &reconstruction_token }; } );
+
+	if( reconstruction_token.stop_requested() ){
+		std::cerr << "Reconstruction stopped\n";
+		return 2;
+	}
+
+	if( !filtered_projections_path.empty() && !Export( filtered_projections, filtered_projections_path ) ){
+		std::cerr << "Could not write " << filtered_projections_path << "\n";
+		return 2;
+	}
+
+	if( backprojection_path.empty() ) return 0;
+
+	const Backprojection backprojection = RunWithProgress( reconstruction_token, [ & ]( void ){
+		return Backprojection{ filtered_projections, &reconstruction_token }; } );
+
+	if( reconstruction_token.stop_requested() ){
+		std::cerr << "Reconstruction stopped\n";
+		return 2;
+	}
+
+	if( !Export( backprojection, backprojection_path ) ){
+		std::cerr << "Could not write " << backprojection_path << "\n";
+		return 2;
+	}
+
+	return 0;
+}
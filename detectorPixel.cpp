@@ -10,6 +10,9 @@
 	Includes
  *********************************************************************/
 
+#include <algorithm>
+#include <tuple>
+
 #include "detectorPixel.h"
 
 
@@ -26,19 +29,23 @@
 optional<double> DetectorPixel::GetProjectionValue( 
 																	const bool use_simple_absorption, 
 																	const size_t expected_ray_hits, 
-																	const double start_intensity ) const{
+																	const double start_intensity,
+																	const DetectedRays detected_rays ) const{
 
 	double sum_of_end_intensity = 0.;
 	double sum_of_simple_end_intensity = 0.;
 
+	// sum in fixed order so that the result does not depend on the order of detection
+	const vector<const RayProperties*> sorted_properties = GetOrderedRayProperties( detected_rays );
+
 	// iterate all detected ray properties
-	for( const RayProperties& currentRay : detected_ray_properties_ ){
-		sum_of_end_intensity += currentRay.energy_spectrum_.GetTotalPower();
-		sum_of_simple_end_intensity += currentRay.simple_intensity();
+	for( const RayProperties* currentRay : sorted_properties ){
+		sum_of_end_intensity += currentRay->energy_spectrum_.GetTotalPower();
+		sum_of_simple_end_intensity += currentRay->simple_intensity();
 	}
 
 	// check no rays were detected return empty
-	if( detected_ray_properties_.size() == 0)
+	if( sorted_properties.size() == 0)
 		return {};
 
 	// calculate line inegral
@@ -53,6 +60,41 @@ optional<double> DetectorPixel::GetProjectionValue(
 	return !use_simple_absorption ? line_integral_spectrum : line_integral_simple;
 }
 
+double DetectorPixel::GetDetectedPower( const bool scattered ) const{
+
+	// sum in fixed order so that the result does not depend on the order of detection
+	double power = 0.;
+	for( const RayProperties* currentRay : GetOrderedRayProperties( scattered ? DetectedRays::Scattered : DetectedRays::Primary ) )
+		power += currentRay->energy_spectrum_.GetTotalPower();
+
+	return power;
+}
+
+vector<const RayProperties*> DetectorPixel::GetOrderedRayProperties( const DetectedRays detected_rays ) const{
+
+	// rays with equal identifier, scattering occurrences and intensities contribute equally to all sums
+	using OrderKey = std::tuple<uint64_t, size_t, double, double>;
+	vector<pair<OrderKey, const RayProperties*>> keyed_properties;
+	keyed_properties.reserve( detected_ray_properties_.size() );
+	for( const RayProperties& currentRay : detected_ray_properties_ ){
+		const bool is_scattered = currentRay.scattering_occurrences() > 0;
+		if( ( detected_rays == DetectedRays::Primary && is_scattered ) || 
+				( detected_rays == DetectedRays::Scattered && !is_scattered ) ) continue;
+		
+		keyed_properties.emplace_back( OrderKey{ currentRay.identifier_, currentRay.scattering_occurrences_, 
+																						 currentRay.energy_spectrum_.GetTotalPower(), currentRay.simple_intensity_ }, &currentRay );
+	}
+
+	std::sort( keyed_properties.begin(), keyed_properties.end(), 
+						 []( const auto& a, const auto& b ){ return a.first < b.first; } );
+
+	vector<const RayProperties*> ordered_properties;
+	ordered_properties.reserve( keyed_properties.size() );
+	for( const auto& [ key, properties ] : keyed_properties ) ordered_properties.push_back( properties );
+
+	return ordered_properties;
+}
+
 DetectorPixel DetectorPixel::ConvertTo( const CoordinateSystem* const target_coordinate_system ) const{
 	return DetectorPixel{ this->BoundedSurface::ConvertTo( target_coordinate_system ), this->detected_ray_properties_ };
 }
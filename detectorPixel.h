@@ -24,6 +24,15 @@
    Definitions
  *********************************************************************/
 
+/*!
+ * @brief selection of detected rays
+*/
+enum class DetectedRays{
+	All,				/*!< primary and scattered rays*/
+	Primary,		/*!< rays which were never scattered*/
+	Scattered		/*!< rays which were scattered at least once*/
+};
+
 /*!
  * @brief class for detector pixel
 */
@@ -70,9 +79,18 @@ class DetectorPixel : public BoundedSurface{
 	 * @param use_simple_absorption if set use ideal model absorption which is not energy dependent
 	 * @param expected_ray_hits the expected amount of rays to hit the pixel
 	 * @param start_intensity start intensities of rays
+	 * @param detected_rays rays to include
 	 * @return value of radon point
 	*/
-	optional<double> GetProjectionValue( const bool use_simple_absorption, const size_t expected_ray_hits, const double start_intensity ) const;
+	optional<double> GetProjectionValue( const bool use_simple_absorption, const size_t expected_ray_hits, const double start_intensity, 
+																			 const DetectedRays detected_rays = DetectedRays::All ) const;
+
+	/*!
+	 * @brief get the power of detected primary or scattered rays
+	 * @param scattered when true the power of scattered rays is returned. Otherwise the power of primary rays
+	 * @return power in watts
+	*/
+	double GetDetectedPower( const bool scattered ) const;
 
 	/*!
 	 * @brief convert this pixel ot given coordinate system
@@ -93,6 +111,16 @@ class DetectorPixel : public BoundedSurface{
 
 	vector<RayProperties> detected_ray_properties_;		/*!< ray properties of rays detected with this pixel*/
 
+
+	/*!
+	 * @brief get the detected rays in a fixed order
+	 * @details rays are ordered by identifier. Rays sharing an identifier are ordered by their values. Sums over the rays 
+	 * then do not depend on the order of detection
+	 * @param detected_rays rays to include
+	 * @return pointer to properties of included rays
+	*/
+	vector<const RayProperties*> GetOrderedRayProperties( const DetectedRays detected_rays ) const;
+
  };
 
 
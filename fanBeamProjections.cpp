@@ -0,0 +1,179 @@
+/*********************************************************************
+ * @file   fanBeamProjections.cpp
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <algorithm>
+#include "fanBeamProjections.h"
+#include "projections.h"
+#include "serialization.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+/*!
+ * FanBeamProjections implementation
+*/
+
+
+const string FanBeamProjections::FILE_PREAMBLE{ "Ver01FANBEAM_PROJECTIONS_FILE_PREAMBLE" };
+
+FanBeamProjections::FanBeamProjections( void ) :
+	DataGrid<>{}
+{}
+
+FanBeamProjections::FanBeamProjections( const ProjectionsProperties properties, const TomographyProperties tomography_properties, 
+																				const size_t number_of_frames, const vector<RadonCoordinates>& pixel_coordinates ) :
+	DataGrid<>{ GridIndex{ ForceToMin1( number_of_frames ), pixel_coordinates.size() }, 
+							GridCoordinates{ 0., 0. }, GridCoordinates{ properties.angles_resolution(), 1. } },
+	properties_( properties ),
+	tomography_properties_( tomography_properties )
+{
+	for( const RadonCoordinates& coordinates : pixel_coordinates ){
+		pixel_angles_.push_back( coordinates.theta );
+		pixel_distances_.push_back( coordinates.distance );
+	}
+}
+
+FanBeamProjections::FanBeamProjections( const vector<char>& binary_data, vector<char>::const_iterator& current_byte ) : 
+	DataGrid<>{ binary_data, current_byte },
+	properties_{ binary_data, current_byte },
+	tomography_properties_{ binary_data, current_byte }
+{
+	for( size_t pixel_index = 0; pixel_index < number_of_pixel(); pixel_index++ ){
+		pixel_angles_.push_back( DeSerializeBuildIn<double>( 0., binary_data, current_byte ) );
+		pixel_distances_.push_back( DeSerializeBuildIn<double>( 0., binary_data, current_byte ) );
+	}
+}
+
+size_t FanBeamProjections::Serialize( vector<char>& binary_data ) const{
+	size_t number_of_bytes = 0;
+
+	number_of_bytes += DataGrid<>::Serialize( binary_data );
+	number_of_bytes += properties_.Serialize( binary_data );
+	number_of_bytes += tomography_properties_.Serialize( binary_data );
+	for( size_t pixel_index = 0; pixel_index < pixel_angles_.size(); pixel_index++ ){
+		number_of_bytes += SerializeBuildIn<double>( pixel_angles_.at( pixel_index ), binary_data );
+		number_of_bytes += SerializeBuildIn<double>( pixel_distances_.at( pixel_index ), binary_data );
+	}
+	return number_of_bytes;
+}
+
+RadonCoordinates FanBeamProjections::GetRadonCoordinates( const size_t frame_index, const size_t pixel_index ) const{
+
+	double theta = pixel_angles_.at( pixel_index ) + static_cast<double>( frame_index ) * properties_.angles_resolution();
+	double distance = pixel_distances_.at( pixel_index );
+
+	// the line with angle theta + pi is the line with angle theta and negative distance. 
+	// Pixel can start with a negative angle
+	while( theta >= PI ){
+		theta -= PI;
+		distance = -distance;
+	}
+	while( theta < 0. ){
+		theta += PI;
+		distance = -distance;
+	}
+
+	return RadonCoordinates{ theta, distance };
+}
+
+vector<double> FanBeamProjections::GetFanAngles( void ) const{
+
+	if( pixel_angles_.empty() ) return vector<double>{};
+
+	// difference of two radon angles in the interval from -pi/2 to pi/2
+	const auto get_angle_difference = []( const double angle, const double reference_angle ){
+		double difference = fmod( angle - reference_angle, PI );
+		if( difference >= PI / 2. ) difference -= PI;
+		if( difference < -PI / 2. ) difference += PI;
+		return difference;
+	};
+
+	// angles relative to the first pixel. The middle of the fan lies between the outermost pixel
+	vector<double> fan_angles;
+	for( const double pixel_angle : pixel_angles_ )
+		fan_angles.push_back( get_angle_difference( pixel_angle, pixel_angles_.front() ) );
+
+	const auto [ min_angle, max_angle ] = std::minmax_element( fan_angles.cbegin(), fan_angles.cend() );
+	const double middle_angle = ( *min_angle + *max_angle ) / 2.;
+
+	for( double& fan_angle : fan_angles ) fan_angle -= middle_angle;
+
+	return fan_angles;
+}
+
+double FanBeamProjections::GetParkerWeight( const double gantry_angle, const double fan_angle, const double half_fan_angle ){
+
+	// outside of the scan
+	if( gantry_angle <= 0. || gantry_angle >= PI + 2. * half_fan_angle ) return 0.;
+
+	// weight rises from zero at the start of the scan
+	if( gantry_angle < 2. * ( half_fan_angle - fan_angle ) )
+		return pow( sin( PI / 4. * gantry_angle / ( half_fan_angle - fan_angle ) ), 2. );
+	
+	// full weight in the middle of the scan
+	if( gantry_angle <= PI - 2. * fan_angle ) return 1.;
+
+	// weight falls to zero at the end of the scan
+	return pow( sin( PI / 4. * ( PI + 2. * half_fan_angle - gantry_angle ) / ( half_fan_angle + fan_angle ) ), 2. );
+}
+
+vector<vector<double>> FanBeamProjections::GetRedundancyWeights( void ) const{
+
+	vector<vector<double>> weights( number_of_frames(), vector<double>( number_of_pixel(), 0. ) );
+
+	// parker weights smoothly suppress the samples at both ends of the scan which are sampled twice
+	if( IsShortScan() ){
+		const vector<double> fan_angles = GetFanAngles();
+
+		// the fan reaches half a pixel beyond the outermost pixel's line. No sample lies on the fan's edge where the weights are discontinuous
+		const double half_fan_angle = std::abs( *std::max_element( fan_angles.cbegin(), fan_angles.cend(), 
+			[]( const double first, const double second ){ return std::abs( first ) < std::abs( second ); } ) ) + properties_.angles_resolution() / 2.;
+
+		for( size_t frame_index = 0; frame_index < number_of_frames(); frame_index++ ){
+
+			// the scan starts one frame before the first recorded frame. The weights of its first and last frame are zero
+			const double gantry_angle = static_cast<double>( frame_index + 1 ) * properties_.angles_resolution();
+			
+			for( size_t pixel_index = 0; pixel_index < number_of_pixel(); pixel_index++ )
+				weights.at( frame_index ).at( pixel_index ) = GetParkerWeight( gantry_angle, fan_angles.at( pixel_index ), half_fan_angle );
+		}
+
+		return weights;
+	}
+
+	// grid of the lines
+	const Projections projections_grid{ properties_, tomography_properties_ };
+
+	// amount of samples of each line
+	vector<vector<size_t>> number_of_samples( projections_grid.size().c, vector<size_t>( projections_grid.size().r, 0 ) );
+
+	for( size_t frame_index = 0; frame_index < number_of_frames(); frame_index++ ){
+		for( size_t pixel_index = 0; pixel_index < number_of_pixel(); pixel_index++ ){
+			const GridIndex index = projections_grid.GetAssignment( GetRadonCoordinates( frame_index, pixel_index ) ).index;
+			number_of_samples.at( index.c ).at( index.r )++;
+		}
+	}
+
+	// samples of a full rotation are weighted equally
+	for( size_t frame_index = 0; frame_index < number_of_frames(); frame_index++ ){
+		for( size_t pixel_index = 0; pixel_index < number_of_pixel(); pixel_index++ ){
+			const GridIndex index = projections_grid.GetAssignment( GetRadonCoordinates( frame_index, pixel_index ) ).index;
+			weights.at( frame_index ).at( pixel_index ) = 1. / static_cast<double>( number_of_samples.at( index.c ).at( index.r ) );
+		}
+	}
+
+	return weights;
+}
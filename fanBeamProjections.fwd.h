@@ -0,0 +1,3 @@
+#pragma once
+
+class FanBeamProjections;
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+/*********************************************************************
+ * @file   fanBeamProjections.h
+ * @brief  class for unrebinned projections of a fan-beam acquisition
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "dataGrid.h"
+#include "projectionsProperties.h"
+#include "radonCoordinates.h"
+#include "tomography.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for the projections of a fan-beam acquisition
+ * @details the data is stored as recorded. Columns are the gantry's frames and rows are the detector's pixel.
+ * The radon coordinates of each pixel in the first frame are stored to locate every sample in radon space
+*/
+class FanBeamProjections : private DataGrid<> {
+
+	public:
+
+	static const string FILE_PREAMBLE; /*!< string to prepend to file when storing as file*/
+
+	/*!
+	 * @brief default constructor
+	*/
+	FanBeamProjections( void );
+
+	/*!
+	 * @brief constructor
+	 * @param properties projections properties of the acquisition. The gantry rotates by the angle resolution between two frames
+	 * @param tomography_properties properties of tomography used to get these projections
+	 * @param number_of_frames amount of recorded frames
+	 * @param pixel_coordinates radon coordinates of each pixel in the first frame
+	*/
+	FanBeamProjections( const ProjectionsProperties properties, const TomographyProperties tomography_properties, 
+											const size_t number_of_frames, const vector<RadonCoordinates>& pixel_coordinates );
+
+	/*!
+	 * @brief constructor from serialized data
+	 * @param binary_data reference to vector with binary data
+	 * @param current_byte iterator to start of data in vector
+	*/
+	FanBeamProjections( const vector<char>& binary_data, vector<char>::const_iterator& current_byte );
+	
+	/*!
+	 * @brief serialize this object
+	 * @param binary_data reference to vector where data will be appended
+	 * @return written bytes
+	*/
+	size_t Serialize( vector<char>& binary_data ) const;
+
+	/*!
+	 * @brief get gridded data
+	 * @return gridded data with frames as columns and pixel as rows
+	*/
+	DataGrid<> data( void ) const{ return static_cast<DataGrid<>>( *this ); };
+
+	/*!
+	 * @brief get projection properties
+	 * @return properties of projections
+	*/
+	ProjectionsProperties properties( void ) const{ return properties_; };
+	
+	/*!
+	 * @brief get tomography properties used for these projections
+	 * @return tomography properties
+	*/
+	TomographyProperties tomography_properties( void ) const{ return tomography_properties_; };
+
+	/*!
+	 * @brief get amount of recorded frames
+	 * @return amount of frames
+	*/
+	size_t number_of_frames( void ) const{ return size().c; };
+
+	/*!
+	 * @brief get amount of pixel
+	 * @return amount of pixel
+	*/
+	size_t number_of_pixel( void ) const{ return size().r; };
+
+	/*!
+	 * @brief assign data of a pixel in a frame
+	 * @param frame_index index of frame
+	 * @param pixel_index index of pixel
+	 * @param value line integral
+	*/
+	void AssignData( const size_t frame_index, const size_t pixel_index, const double value ){ 
+		this->SetData( GridIndex{ frame_index, pixel_index }, value ); };
+
+	/*!
+	 * @brief get data of a pixel in a frame
+	 * @param frame_index index of frame
+	 * @param pixel_index index of pixel
+	 * @return line integral
+	*/
+	double GetData( const size_t frame_index, const size_t pixel_index ) const{ 
+		return DataGrid<>::GetData( GridIndex{ frame_index, pixel_index } ); };
+
+	/*!
+	 * @brief get the radon coordinates of a sample
+	 * @details angles are mapped to the interval from zero to pi. The distance changes its sign accordingly
+	 * @param frame_index index of frame
+	 * @param pixel_index index of pixel
+	 * @return radon coordinates of the pixel's line in given frame
+	*/
+	RadonCoordinates GetRadonCoordinates( const size_t frame_index, const size_t pixel_index ) const;
+
+	/*!
+	 * @brief get the fan angle of each pixel
+	 * @details the fan angle is the pixel's radon angle relative to the middle of the fan. 
+	 * It grows in the direction of the gantry's rotation
+	 * @return fan angle of each pixel
+	*/
+	vector<double> GetFanAngles( void ) const;
+
+	/*!
+	 * @brief check if less than a full rotation was recorded
+	 * @return true when the gantry did not complete a full rotation
+	*/
+	bool IsShortScan( void ) const{ return number_of_frames() < 2 * properties_.number_of_projections(); };
+
+	/*!
+	 * @brief get the weight of each sample
+	 * @details every line through the measuring field is sampled once in half a rotation. The weights of all samples of 
+	 * the same line sum up to one. Samples of a full rotation are weighted equally. Samples of a short scan get parker weights. 
+	 * A short scan must cover half a rotation and the fan angle. These are the frames to fill the parallel projections grid
+	 * @return weight for each frame and pixel
+	*/
+	vector<vector<double>> GetRedundancyWeights( void ) const;
+
+	/*!
+	 * @brief get parker weight of a sample
+	 * @details the weights of a sample and its conjugate sample at gantry angle plus pi plus twice the fan angle sum up to one
+	 * @param gantry_angle rotation angle of the gantry since the first frame
+	 * @param fan_angle fan angle of the pixel
+	 * @param half_fan_angle half of the fan angle. Must not be less than any pixel's fan angle. The scan covers pi and twice this angle
+	 * @return weight between zero and one
+	*/
+	static double GetParkerWeight( const double gantry_angle, const double fan_angle, const double half_fan_angle );
+
+
+	private:
+
+	ProjectionsProperties properties_;						/*!< properties of projection*/
+	TomographyProperties tomography_properties_;	/*!< tomography properties used*/
+	vector<double> pixel_angles_;									/*!< radon angle of each pixel in the first frame*/
+	vector<double> pixel_distances_;							/*!< radon distance of each pixel in the first frame*/
+};
@@ -13,7 +13,6 @@
 #include <thread>
 using std::ref;
 using std::cref;
-#include <FL/Fl.H>
 #include "filteredProjections.h"
 
 
@@ -28,7 +27,7 @@ const string FilteredProjections::FILE_PREAMBLE{ "FILTEREDPROJECTIONS_FILE_PREAM
 FilteredProjections::FilteredProjections( 
 											const Projections& projections, 
 											const BackprojectionFilter::TYPE filter_type, 
-											Fl_Progress_Window* progress_window ) :
+											ProgressToken* progress_token ) :
 
 	DataGrid{ projections.data().size(), projections.data().start(), 
 						projections.data().resolution(), 0. },
@@ -45,13 +44,19 @@ FilteredProjections::FilteredProjections(
 	// local copy of projection data
 	const DataGrid<> projections_data = projections.data();
 
+	if( progress_token != nullptr ) 
+		progress_token->SetTotal( number_of_angles );
+
 	// iterate all angles
 	for( size_t angle_index = 0; angle_index < number_of_angles; angle_index++ ){
 
-		if( progress_window != nullptr )
-			progress_window->ChangeLineText( 0, "Filtering angle " 
-																					+ ConvertToString( angle_index + 1 )
-																				  + " of " + ConvertToString( number_of_angles ) );
+		if( progress_token != nullptr ){
+			if( progress_token->stop_requested() ) break;
+
+			progress_token->SetLine( 0, "Filtering angle " 
+																		+ ConvertToString( angle_index + 1 )
+																		+ " of " + ConvertToString( number_of_angles ) );
+		}
 
 		// iterate all distances
 		for( size_t distance_index = 0; 
@@ -97,8 +102,54 @@ FilteredProjections::FilteredProjections(
 			this->SetData( GridIndex{ angle_index, distance_index }, convolution_sum );
 
 		}
-		Fl::check();
+		
+		if( progress_token != nullptr ) 
+			progress_token->Advance();
+	}
+}
+
+
+FilteredProjections::FilteredProjections( 
+											const FanBeamProjections& projections, 
+											const BackprojectionFilter::TYPE filter_type, 
+											ProgressToken* progress_token ) :
+	FilteredProjections{ GetWeightedProjections( projections ), filter_type, progress_token }
+{}
+
+
+Projections FilteredProjections::GetWeightedProjections( const FanBeamProjections& projections ){
+
+	Projections weighted_projections{ projections.properties(), projections.tomography_properties() };
+
+	// weights of redundant samples sum up to one for each line
+	const vector<vector<double>> weights = projections.GetRedundancyWeights();
+
+	vector<vector<double>> weighted_sums( weighted_projections.size().c, 
+																				vector<double>( weighted_projections.size().r, 0. ) );
+	vector<vector<bool>> is_sampled( weighted_projections.size().c, 
+																	 vector<bool>( weighted_projections.size().r, false ) );
+
+	for( size_t frame_index = 0; frame_index < projections.number_of_frames(); frame_index++ ){
+		for( size_t pixel_index = 0; pixel_index < projections.number_of_pixel(); pixel_index++ ){
+			
+			const GridIndex index = weighted_projections.GetAssignment( 
+				projections.GetRadonCoordinates( frame_index, pixel_index ) ).index;
+			
+			weighted_sums.at( index.c ).at( index.r ) += weights.at( frame_index ).at( pixel_index ) * 
+																									 projections.GetData( frame_index, pixel_index );
+			is_sampled.at( index.c ).at( index.r ) = true;
+		}
 	}
+
+	// unsampled lines stay zero
+	for( size_t angle_index = 0; angle_index < weighted_projections.size().c; angle_index++ ){
+		for( size_t distance_index = 0; distance_index < weighted_projections.size().r; distance_index++ ){
+			if( is_sampled.at( angle_index ).at( distance_index ) )
+				weighted_projections.AssignData( GridIndex{ angle_index, distance_index }, weighted_sums.at( angle_index ).at( distance_index ) );
+		}
+	}
+
+	return weighted_projections;
 }
 
 
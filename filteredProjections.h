@@ -14,8 +14,9 @@
 #include "generel.h"
 #include "backprojectionFilter.h"
 #include "projections.h"
+#include "fanBeamProjections.h"
 #include "dataGrid.h"
-#include "fl_ProgressWindow.h"
+#include "progressToken.h"
 
 
 
@@ -41,9 +42,18 @@ class FilteredProjections : private DataGrid<> {
 	 * @brief constructor
 	 * @param projections unfiltered projections 
 	 * @param filter_type type of filter to apply
-	 * @param progress_window FL_window to track progress
+	 * @param progress_token token to report progress and to stop. The data is incomplete when stop was requested
 	*/
-	FilteredProjections( const Projections& projections, const BackprojectionFilter::TYPE filter_type, Fl_Progress_Window* progress_window = nullptr );
+	FilteredProjections( const Projections& projections, const BackprojectionFilter::TYPE filter_type, ProgressToken* progress_token = nullptr );
+
+	/*!
+	 * @brief constructor for projections of a fan-beam acquisition
+	 * @details the samples are weighted by their redundancy and accumulated at their radon coordinates before filtering
+	 * @param projections unfiltered fan-beam projections 
+	 * @param filter_type type of filter to apply
+	 * @param progress_token token to report progress and to stop. The data is incomplete when stop was requested
+	*/
+	FilteredProjections( const FanBeamProjections& projections, const BackprojectionFilter::TYPE filter_type, ProgressToken* progress_token = nullptr );
 
 	/*!
 	 * @brief constructor from serialized data
@@ -104,4 +114,12 @@ class FilteredProjections : private DataGrid<> {
 
 	BackprojectionFilter filter_;		/*!< filter used in backprojection*/
 
+
+	/*!
+	 * @brief get the weighted sum of all samples of each line
+	 * @param projections fan-beam projections
+	 * @return projections with the weighted samples
+	*/
+	static Projections GetWeightedProjections( const FanBeamProjections& projections );
+
 };
\ No newline at end of file
@@ -10,6 +10,8 @@
 	Includes
  *********************************************************************/
 
+#include <FL/Fl.H>
+
 #include "fl_MainWindow.h"
 #include "fl_ProcessingWindow.h"
 #include "programState.h"
@@ -52,6 +54,8 @@ Fl_ProcessingWindow::Fl_ProcessingWindow( int w, int h, const char* label, const
 	limited_projections_( raw_projections_ ),
 	filtered_projections_{ FilteredProjections{}, "saved.filteredprojections", true },
 	backprojection_{ Backprojection{}, "saved.backprojection", true },
+	reconstruction_job_{},
+	reconstruction_pending_( false ),
 
 	recalculate_callback_{ *this, &Fl_ProcessingWindow::FilterAndReconstructImage },
 	filter_change_callback_{ *this, &Fl_ProcessingWindow::FilterAndReconstructImage },
@@ -162,12 +166,23 @@ Fl_ProcessingWindow::Fl_ProcessingWindow( int w, int h, const char* label, const
 }
 
 
-void Fl_ProcessingWindow::FilterAndReconstructImage(void) {
-	main_window_->deactivate();
-	this->deactivate();
- 
+Fl_ProcessingWindow::~Fl_ProcessingWindow( void ){
+	Fl::remove_timeout( HandleReconstructionTimeout, this );
+}
+
+void Fl_ProcessingWindow::FilterAndReconstructImage( void ){
 
-	Fl_Progress_Window* processing_progress_window = new Fl_Progress_Window{ (Fl_Window*)this, 16, 2, "Processing progress" };
+	// the newest request starts once the running reconstruction stopped
+	if( reconstruction_job_ != nullptr ){
+		reconstruction_job_->Stop();
+		reconstruction_pending_ = true;
+		return;
+	}
+
+	StartReconstruction();
+}
+
+void Fl_ProcessingWindow::StartReconstruction( void ){
 
 	Projections *projections_to_use = &raw_projections_;
 
@@ -182,28 +197,61 @@ void Fl_ProcessingWindow::FilterAndReconstructImage(void) {
 		projections_to_use = &limited_projections_;
 	}
 
-	filtered_projections_ = std::move( FilteredProjections{ *projections_to_use, BackprojectionFilter::GetType( filter_type_selector_.current_element() ), processing_progress_window } );
+	reconstruction_job_ = std::make_unique<ReconstructionJob>( *projections_to_use, BackprojectionFilter::GetType( filter_type_selector_.current_element() ) );
 
-	if( filtered_projections_.filter().type() == BackprojectionFilter::TYPE::constant )
-		filter_plot_.hide();
-	else
-		filter_plot_.show();
+	Fl::add_timeout( job_update_interval_s_, HandleReconstructionTimeout, this );
+}
 
-	filter_plot_.SetLimits( PlotLimits{ false, true, filtered_projections_.filter().GetRelevantRange(), NumberRange{}, 1., pow( filtered_projections_.resolution().r, 2.) } );
-	filter_plot_.plot().AssignData(filtered_projections_.filter().GetPlotValues() );
-	filter_plot_.AssignData();
-	
-	filtered_projections_image_.AssignImage( std::move( GrayscaleImage{ filtered_projections_.data_grid(), true } ) );
-	filtered_projections_image_.SetAxis( { filtered_projections_.start().c, filtered_projections_.start().r }, {filtered_projections_.resolution().c, filtered_projections_.resolution().r}, {7, 4});
+void Fl_ProcessingWindow::UpdateReconstruction( void ){
+
+	if( reconstruction_job_ == nullptr ) return;
+
+	if( !reconstruction_job_->finished() ){
+		
+		const ProgressToken& progress_token = reconstruction_job_->progress_token();
+		const size_t total_steps = progress_token.total_steps();
+		if( total_steps > 0 ){
+			const size_t percentage = std::min( progress_token.completed_steps() * 100 / total_steps, static_cast<size_t>( 100 ) );
+			reconstructed_image_.copy_label( ( "Backprojection - " + std::to_string( percentage ) + "%" ).c_str() );
+		}
+
+		Fl::repeat_timeout( job_update_interval_s_, HandleReconstructionTimeout, this );
+		return;
+	}
+
+	// stopped reconstructions have no results and the current images stay
+	if( reconstruction_job_->backprojection().has_value() && !reconstruction_pending_ ){
 
-	backprojection_ = std::move( Backprojection{ filtered_projections_, processing_progress_window } );
+		filtered_projections_ = std::move( reconstruction_job_->filtered_projections().value() );
+
+		if( filtered_projections_.filter().type() == BackprojectionFilter::TYPE::constant )
+			filter_plot_.hide();
+		else
+			filter_plot_.show();
+
+		filter_plot_.SetLimits( PlotLimits{ false, true, filtered_projections_.filter().GetRelevantRange(), NumberRange{}, 1., pow( filtered_projections_.resolution().r, 2.) } );
+		filter_plot_.plot().AssignData(filtered_projections_.filter().GetPlotValues() );
+		filter_plot_.AssignData();
+		
+		filtered_projections_image_.AssignImage( std::move( GrayscaleImage{ filtered_projections_.data_grid(), true } ) );
+		filtered_projections_image_.SetAxis( { filtered_projections_.start().c, filtered_projections_.start().r }, {filtered_projections_.resolution().c, filtered_projections_.resolution().r}, {7, 4});
 
-	UpdateImage();
+		backprojection_ = std::move( reconstruction_job_->backprojection().value() );
 
-	delete processing_progress_window;
+		UpdateImage();
+	}
+
+	reconstruction_job_.reset();
+	reconstructed_image_.copy_label( "Backprojection" );
+
+	if( reconstruction_pending_ ){
+		reconstruction_pending_ = false;
+		StartReconstruction();
+	}
+}
 
-	this->activate();
-	main_window_->activate();
+void Fl_ProcessingWindow::HandleReconstructionTimeout( void* processing_window ){
+	static_cast<Fl_ProcessingWindow*>( processing_window )->UpdateReconstruction();
 }
 
 void Fl_ProcessingWindow::ExportFilteredProjections( void ){
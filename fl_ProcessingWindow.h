@@ -19,6 +19,8 @@
 #include "linePlot.h"
 #include "fl_BoundInput.h"
 #include <FL/Fl_Float_Input.H>
+#include <FL/Fl_Multiline_Output.H>
+#include <memory>
 
 #include "fl_MainWindow.fwd.h"
 #include "fileChooser.h"
@@ -26,6 +28,7 @@
 #include "persistingObject.h"
 #include "filteredProjections.h"
 #include "backprojection.h"
+#include "reconstructionJob.h"
 #include "widgets.h"
 #include "callbackFunction.h"
 #include "tomography.h"
@@ -52,9 +55,17 @@ class Fl_ProcessingWindow : public Fl_Window{
 	*/
 	Fl_ProcessingWindow( int w, int h, const char* label, const Projections& projections, Fl_MainWindow* const main_window );
 
+	/*!
+	 * @brief destructor
+	 * @details stops a running reconstruction
+	*/
+	~Fl_ProcessingWindow( void );
+
 	
 	private:
 
+	static constexpr double job_update_interval_s_ = .1;	/*!< interval to check a running reconstruction*/
+
 	Fl_MainWindow* const main_window_;												/*!< pointer to parent main window*/
 
 	Fl_AdjustableGrayscaleImage projections_image_;			/*!< widget for sinogram display*/
@@ -82,6 +93,8 @@ class Fl_ProcessingWindow : public Fl_Window{
 	Projections limited_projections_;															/*!< projections with upper value limit*/
 	PersistingObject<FilteredProjections> filtered_projections_;	/*!< current filtered projections*/
 	PersistingObject<Backprojection> backprojection_;							/*!< current image reconstructed from filtered projections*/
+	std::unique_ptr<ReconstructionJob> reconstruction_job_;				/*!< reconstruction running in the background*/
+	bool reconstruction_pending_;																	/*!< flag for a reconstruction requested while another was running*/
 
 	static PersistingObject<FileChooser> export_filteredProjections_file_chooser_;		/*!< file chooser for projections export*/
 	static PersistingObject<FileChooser> export_image_chooser_;												/*!< file chooser for projections export*/
@@ -97,10 +110,27 @@ class Fl_ProcessingWindow : public Fl_Window{
 
 		
 	/*!
-	 * @brief reconstruct the image from projections
+	 * @brief request reconstruction of the image from projections
+	 * @details a running reconstruction is stopped and superseded. Current images stay until the new ones are ready
 	*/
 	void FilterAndReconstructImage( void );
 
+	/*!
+	 * @brief start a reconstruction with the current settings
+	*/
+	void StartReconstruction( void );
+
+	/*!
+	 * @brief update progress and take the results of a finished reconstruction
+	*/
+	void UpdateReconstruction( void );
+
+	/*!
+	 * @brief timeout callback for the running reconstruction
+	 * @param processing_window pointer to the processing window
+	*/
+	static void HandleReconstructionTimeout( void* processing_window );
+
 	/*!
 	 * @brief update backprojected image
 	*/
@@ -12,6 +12,8 @@
 *********************************************************************/
 
 
+#include <FL/Fl.H>
+
 #include "fl_TomographyExecution.h"
 #include "fl_GantryCreation.h"
 
@@ -33,27 +35,40 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	scattering_absorption_factor_input_{  X( tomography_properties_group_, .0 ),	Y( tomography_properties_group_, .2 ),	W( tomography_properties_group_, .45 ),	H( tomography_properties_group_, .045 ), "Absorption factor" },
 	use_simple_absorption_button_{				X( tomography_properties_group_, .0 ),	Y( tomography_properties_group_, .3 ),	W( tomography_properties_group_, .45 ),	H( tomography_properties_group_, .05 ), "Simple absorption" },
 	simulation_quality_input_{						X( tomography_properties_group_, .0 ),	Y( tomography_properties_group_, .4 ),	W( tomography_properties_group_, .45 ),	H( tomography_properties_group_, .05 ), "Simulation quality" },
-	information_{													X( tomography_properties_group_, 0. ),	Y( tomography_properties_group_, .5 ),	W( tomography_properties_group_, .95 ),	H( tomography_properties_group_, .4 ), "Information" },
+	forced_detection_button_{							X( tomography_properties_group_, .5 ),	Y( tomography_properties_group_, .4 ),	W( tomography_properties_group_, .3 ),	H( tomography_properties_group_, .05 ), "Forced detection" },
+	max_rays_per_iteration_input_{				X( tomography_properties_group_, .5 ),	Y( tomography_properties_group_, .2 ),	W( tomography_properties_group_, .45 ),	H( tomography_properties_group_, .045 ), "Maximum rays" },
+	random_seed_input_{										X( tomography_properties_group_, .82 ),	Y( tomography_properties_group_, .3 ),	W( tomography_properties_group_, .13 ),	H( tomography_properties_group_, .05 ), "Seed" },
+	quasi_random_button_{									X( tomography_properties_group_, .82 ),	Y( tomography_properties_group_, .4 ),	W( tomography_properties_group_, .13 ),	H( tomography_properties_group_, .05 ), "QMC" },
+	scatter_kernel_button_{								X( tomography_properties_group_, .5 ),	Y( tomography_properties_group_, .48 ),	W( tomography_properties_group_, .3 ),	H( tomography_properties_group_, .05 ), "Scatter kernel" },
+	split_projections_button_{						X( tomography_properties_group_, .82 ),	Y( tomography_properties_group_, .48 ),	W( tomography_properties_group_, .13 ),	H( tomography_properties_group_, .05 ), "Split" },
+	information_{													X( tomography_properties_group_, 0. ),	Y( tomography_properties_group_, .58 ),	W( tomography_properties_group_, .95 ),	H( tomography_properties_group_, .37 ), "Information" },
 
 	control_group_{								X( *this, .0 ),						vOff( tomography_properties_group_ ), W( *this, 1. ), H( *this, .1 ) },
 	name_input_{									X( control_group_, .05 ), Y( control_group_, .1 ), W( control_group_, .9 ), H( control_group_, .4 ), "Name" },			
 	record_slice_button_{					X( control_group_, .05 ), Y( control_group_, .6 ), W( control_group_, .4 ), H( control_group_, .4 ), "Record Slice" },
 	export_projections_button_{		X( control_group_, .55 ), Y( control_group_, .6 ), W( control_group_, .4 ), H( control_group_, .4 ), "Export Projectiions" },
 
+	jobs_group_{									X( *this, .0 ),						vOff( control_group_ ), W( *this, 1. ), H( *this, .24 ) },
+	preview_image_{								X( jobs_group_, .05 ),		Y( jobs_group_, .1 ),		W( jobs_group_, .9 ),		H( jobs_group_, .6 ), "Preview" },
+	job_status_{									X( jobs_group_, .05 ),		Y( jobs_group_, .75 ),	W( jobs_group_, .6 ),		H( jobs_group_, .15 ) },
+	stop_job_button_{							X( jobs_group_, .7 ),			Y( jobs_group_, .75 ),	W( jobs_group_, .25 ),	H( jobs_group_, .15 ), "Stop" },
 	
 	main_window_( main_window ),
 
 	export_projections_file_chooser_{ FileChooser{ "Export projections", "*.projections", path{ "./" }, Fl_Native_File_Chooser::Type::BROWSE_SAVE_FILE }, "projectionsExport.chooser" },
 	
 	tomography_properties_{ TomographyProperties{}, "saved.tomographyproperties" },
-	tomography_{},
 	
 	projections_{ Projections{}, "saved.projections" },
+	running_job_{},
+	queued_jobs_{},
+	shown_preview_revision_( 0 ),
 	processing_windows_( 0 ),
 
 	record_slice_callback_{ *this, &Fl_TomographyExecution::DoTomography },
 	update_properties_callback_{ *this, &Fl_TomographyExecution::UpdateProperties },
-	export_projections_callback_{ *this, &Fl_TomographyExecution::ExportProjections }
+	export_projections_callback_{ *this, &Fl_TomographyExecution::ExportProjections },
+	stop_job_callback_{ *this, &Fl_TomographyExecution::StopJob }
 {
 
 
@@ -69,6 +84,12 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	tomography_properties_group_.add( disable_scattering_button_ );
 	tomography_properties_group_.add( use_simple_absorption_button_ );
 	tomography_properties_group_.add( simulation_quality_input_ );
+	tomography_properties_group_.add( forced_detection_button_ );
+	tomography_properties_group_.add( max_rays_per_iteration_input_ );
+	tomography_properties_group_.add( random_seed_input_ );
+	tomography_properties_group_.add( quasi_random_button_ );
+	tomography_properties_group_.add( scatter_kernel_button_ );
+	tomography_properties_group_.add( split_projections_button_ );
 	tomography_properties_group_.add( information_ );
 	tomography_properties_group_.add( scattering_absorption_factor_input_ );
 
@@ -79,6 +100,8 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	scattering_propability_factor_input_.align( FL_ALIGN_TOP );
 	scattering_absorption_factor_input_.align( FL_ALIGN_TOP );
 	simulation_quality_input_.align( FL_ALIGN_TOP );
+	max_rays_per_iteration_input_.align( FL_ALIGN_TOP );
+	random_seed_input_.align( FL_ALIGN_TOP );
 
 	maximum_scatterings_input_.bounds(0, 100);
 	maximum_scatterings_input_.step( 1. );
@@ -88,6 +111,10 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	scattering_absorption_factor_input_.bounds( .0, 100. );
 	scattering_absorption_factor_input_.step( .5 );
 	scattering_absorption_factor_input_.lstep( 10. );
+	max_rays_per_iteration_input_.bounds( 0., 100000000. );
+	max_rays_per_iteration_input_.step( 1000. );
+	max_rays_per_iteration_input_.lstep( 100000. );
+	random_seed_input_.SetProperties( 0, UINT32_MAX, 0 );
 	
 
 
@@ -97,6 +124,12 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	disable_scattering_button_.tooltip( "Enable or disable scattering." );
 	use_simple_absorption_button_.tooltip( "If enabled \"simple\" absorption is active which is not energy dependent." );
 	simulation_quality_input_.tooltip( "Change quality of simulation. Low number is faster but not as realistic." );
+	max_rays_per_iteration_input_.tooltip( "Maximum amount of scattered rays traced in one iteration. Enables russian roulette and splitting. Zero for no limit." );
+	random_seed_input_.tooltip( "Seed for random numbers. Identical seed and parameters give identical projections." );
+	quasi_random_button_.tooltip( "Use quasi random numbers from scrambled halton sequences instead of pseudo random numbers." );
+	scatter_kernel_button_.tooltip( "Approximate scattering by convolving primary projections with precomputed scatter kernels. Kernels are generated once and stored." );
+	split_projections_button_.tooltip( "Additionally record spectral, simple, primary and scatter projections in the same run." );
+	forced_detection_button_.tooltip( "Add the expected contribution of each scattering to all pixel instead of tracing random scattered rays. Only single scattering is simulated." );
 
 	maximum_scatterings_input_.value( static_cast<double>( tomography_properties_.max_scattering_occurrences ) );
 	scattering_propability_factor_input_.value( tomography_properties_.scatter_propability_correction*100. );
@@ -105,6 +138,16 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	use_simple_absorption_button_.value( static_cast<int>( tomography_properties_.use_simple_absorption ) );
 	disable_scattering_button_.color( FL_BACKGROUND_COLOR, FL_DARK_GREEN );
 	use_simple_absorption_button_.color( FL_BACKGROUND_COLOR, FL_DARK_GREEN );
+	forced_detection_button_.value( static_cast<int>( tomography_properties_.forced_detection ) );
+	forced_detection_button_.color( FL_BACKGROUND_COLOR, FL_DARK_GREEN );
+	max_rays_per_iteration_input_.value( static_cast<double>( tomography_properties_.max_rays_per_iteration ) );
+	random_seed_input_.value( tomography_properties_.random_seed );
+	quasi_random_button_.value( static_cast<int>( tomography_properties_.quasi_random_sampling ) );
+	quasi_random_button_.color( FL_BACKGROUND_COLOR, FL_DARK_GREEN );
+	scatter_kernel_button_.value( static_cast<int>( tomography_properties_.scatter_kernel_mode ) );
+	scatter_kernel_button_.color( FL_BACKGROUND_COLOR, FL_DARK_GREEN );
+	split_projections_button_.value( static_cast<int>( tomography_properties_.record_split_projections ) );
+	split_projections_button_.color( FL_BACKGROUND_COLOR, FL_DARK_GREEN );
 
 	simulation_quality_input_.bounds( 1., 100. );
 	simulation_quality_input_.step( 1. );
@@ -118,6 +161,12 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	disable_scattering_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
 	use_simple_absorption_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
 	simulation_quality_input_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
+	forced_detection_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
+	max_rays_per_iteration_input_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
+	random_seed_input_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
+	quasi_random_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
+	scatter_kernel_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
+	split_projections_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_ );
 
 	information_.align( FL_ALIGN_TOP );
 	information_.textfont( FL_COURIER );
@@ -135,10 +184,29 @@ Fl_TomographyExecution::Fl_TomographyExecution( int x, int y, int w, int h, Fl_M
 	name_input_.callback(  CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &update_properties_callback_  );
 	record_slice_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &record_slice_callback_ );
 	export_projections_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &export_projections_callback_ );
+	record_slice_button_.tooltip( "Record a slice in the background. Queued when another recording is running." );
+
+	Fl_Group::add( jobs_group_ );
+
+	jobs_group_.add( preview_image_ );
+	jobs_group_.add( job_status_ );
+	jobs_group_.add( stop_job_button_ );
+
+	preview_image_.align( FL_ALIGN_TOP );
+	job_status_.box( FL_NO_BOX ); job_status_.align( FL_ALIGN_LEFT | FL_ALIGN_INSIDE );
+	stop_job_button_.tooltip( "Stop the running recording. Queued recordings start afterwards." );
+	stop_job_button_.callback( CallbackFunction<Fl_TomographyExecution>::Fl_Callback, &stop_job_callback_ );
+	stop_job_button_.deactivate();
+
+	UpdateJobStatus();
 
 	this->deactivate();
 }
 
+Fl_TomographyExecution::~Fl_TomographyExecution( void ){
+	Fl::remove_timeout( HandleJobTimeout, this );
+}
+
 void Fl_TomographyExecution::AssignProjections( const Projections projections ){
 	projections_ = projections;
 
@@ -165,9 +233,16 @@ void Fl_TomographyExecution::UpdateProperties( void ){
 													static_cast<bool>( use_simple_absorption_button_.value() ), 
 													scattering_absorption_factor_input_.value()/100.,
 													name_input_.value(),main_window_.gantry_creation_.gantry().tube().properties().has_filter_,
-													static_cast<size_t>( simulation_quality_input_.value() ) };
-
-	if( simulation_properties.quality != tomography_properties_.simulation_quality ){
+													static_cast<size_t>( simulation_quality_input_.value() ),
+													static_cast<bool>( forced_detection_button_.value() ),
+													static_cast<size_t>( max_rays_per_iteration_input_.value() ),
+													random_seed_input_.value(),
+													static_cast<bool>( quasi_random_button_.value() ),
+													static_cast<bool>( scatter_kernel_button_.value() ),
+													static_cast<bool>( split_projections_button_.value() ) };
+
+	// a running recording uses the gantry. it is updated when the next recording starts
+	if( running_job_ == nullptr && simulation_properties.quality != tomography_properties_.simulation_quality ){
 		simulation_properties = SimulationProperties{ tomography_properties_.simulation_quality };
 		main_window_.gantry_creation_.UpdateGantry();
 	}
@@ -178,25 +253,114 @@ void Fl_TomographyExecution::UpdateProperties( void ){
 
 void Fl_TomographyExecution::DoTomography( void ){
 
-		main_window_.deactivate();
+	// a queued recording keeps the properties at the time of queueing
+	queued_jobs_.push_back( tomography_properties_ );
+
+	if( running_job_ == nullptr )
+		StartNextJob();
+	else
+		UpdateJobStatus();
+}
+
+void Fl_TomographyExecution::StartNextJob( void ){
+
+	if( queued_jobs_.empty() ){
+		main_window_.model_view_.activate();
+		main_window_.gantry_creation_.activate();
+		stop_job_button_.deactivate();
+		UpdateJobStatus();
+		return;
+	}
+
+	TomographyProperties job_properties = queued_jobs_.front();
+	queued_jobs_.pop_front();
+
+	// the gantry depends on the simulation quality and is only changed between recordings
+	if( simulation_properties.quality != job_properties.simulation_quality ){
+		simulation_properties = SimulationProperties{ job_properties.simulation_quality };
+		main_window_.gantry_creation_.UpdateGantry();
+	}
+
+	job_properties.mean_energy_of_tube = main_window_.gantry_creation_.gantry().tube().GetMeanEnergy();
+	job_properties.filter_active = main_window_.gantry_creation_.gantry().tube().properties().has_filter_;
+
+	// the recording uses gantry and model on its own thread
+	main_window_.model_view_.deactivate();
+	main_window_.gantry_creation_.deactivate();
+
+	shown_preview_revision_ = 0;
+	running_job_ = std::make_unique<TomographyJob>( job_properties, main_window_.gantry_creation_.projections_properties(), 
+																									main_window_.gantry_creation_.gantry(), main_window_.model_view_.model() );
+	
+	stop_job_button_.activate();
+	UpdateJobStatus();
+
+	Fl::add_timeout( job_update_interval_s_, HandleJobTimeout, this );
+}
+
+void Fl_TomographyExecution::StopJob( void ){
+	if( running_job_ != nullptr ) running_job_->Stop();
+}
+
+void Fl_TomographyExecution::UpdateJob( void ){
+
+	if( running_job_ == nullptr ) return;
+
+	// redraw the preview only when the recording published new projections
+	const ProjectionsPreview& preview = running_job_->preview();
+	const size_t preview_revision = preview.revision();
+	if( preview_revision != shown_preview_revision_ ){
+		shown_preview_revision_ = preview_revision;
+		preview_image_.AssignImage( GrayscaleImage{ preview.projections().data(), true } );
+	}
+
+	UpdateJobStatus();
+
+	if( !running_job_->finished() ){
+		Fl::repeat_timeout( job_update_interval_s_, HandleJobTimeout, this );
+		return;
+	}
+
+	// the job stays assigned while processing windows open so that new recordings are queued
+	optional<Projections>& new_projections = running_job_->projections();
 
-		Fl_Progress_Window* radiationProgressWindow = new Fl_Progress_Window{ (Fl_Window*) window(), 16, 2, "Radiation progress"};
-		
-		tomography_properties_.mean_energy_of_tube =  main_window_.gantry_creation_.gantry().tube().GetMeanEnergy();
-		tomography_properties_.filter_active =  main_window_.gantry_creation_.gantry().tube().properties().has_filter_;
+	if( new_projections.has_value() ){
+		preview_image_.AssignImage( GrayscaleImage{ new_projections.value().data(), true } );
 
-		tomography_ = Tomography{ tomography_properties_ };
+		AssignProjections( std::move( new_projections.value() ) );
 
-		if( radiationProgressWindow != nullptr ){
-			optional<Projections> new_projections = tomography_.RecordSlice( main_window_.gantry_creation_.projections_properties(), main_window_.gantry_creation_.gantry(), main_window_.model_view_.model(), 0, radiationProgressWindow);
-			
-			if( new_projections.has_value() ){
-				AssignProjections( std::move( new_projections.value() ) );
-			}
-			delete radiationProgressWindow;
+		// open the split projections in their own processing windows
+		for( const Projections& single_split_projections : running_job_->split_projections() ){
+			processing_windows_.push_back( std::make_unique<Fl_ProcessingWindow>( static_cast<int>( 1920. * 0.9 ), static_cast<int>( 1080. * 0.9 ), 
+																																						 "Processing", single_split_projections, &main_window_ ) );
 		}
+	}
+
+	running_job_.reset();
+	StartNextJob();
+}
+
+void Fl_TomographyExecution::UpdateJobStatus( void ){
+
+	string status = "No recording running";
+
+	if( running_job_ != nullptr ){
+		const ProgressToken& progress_token = running_job_->progress_token();
+		status = "Recording \"" + running_job_->properties().name + "\"";
+
+		const size_t total_steps = progress_token.total_steps();
+		if( total_steps > 0 )
+			status += " " + std::to_string( std::min( progress_token.completed_steps() * 100 / total_steps, static_cast<size_t>( 100 ) ) ) + "%";
+	}
+
+	if( !queued_jobs_.empty() )
+		status += " - " + std::to_string( queued_jobs_.size() ) + " queued";
+
+	job_status_.copy_label( status.c_str() );
+}
 
-		main_window_.activate();
+void Fl_TomographyExecution::HandleJobTimeout( void* tomography_execution ){
+	static_cast<Fl_TomographyExecution*>( tomography_execution )->UpdateJob();
 }
 
 
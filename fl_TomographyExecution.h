@@ -17,17 +17,22 @@
 #include <FL/Fl_Box.H>
 #include <FL/Fl_Simple_Counter.H>
 #include <FL/Fl_Float_Input.H>
+#include <FL/Fl_Int_Input.H>
 #include <FL/Fl_Toggle_Button.H>
+#include <FL/Fl_Multiline_Output.H>
 #include <memory>
+#include <deque>
 
 #include "fl_BoundInput.h"
 #include "fl_ProcessingWindow.h"
+#include "fl_GrayscaleImage.h"
 #include "fl_MainWindow.fwd.h"
 
 #include "persistingObject.h"
 #include "widgets.h"
 #include "callbackFunction.h"
 #include "tomography.h"
+#include "tomographyJob.h"
 #include "fileChooser.h"
 
 
@@ -48,6 +53,12 @@ class Fl_TomographyExecution : public Fl_Group{
 	*/
 	Fl_TomographyExecution( int x, int y, int w, int h, Fl_MainWindow& main_window );
 
+	/*!
+	 * @brief destructor
+	 * @details stops a running recording
+	*/
+	~Fl_TomographyExecution( void );
+
 	/*!
 	 * @brief set information update flag
 	*/
@@ -67,6 +78,8 @@ class Fl_TomographyExecution : public Fl_Group{
 
 	private:
 
+	static constexpr double job_update_interval_s_ = .1;	/*!< interval to update the preview and status of a running recording*/
+
 	Fl_Box title_;				/*!< title*/
 
 	Fl_Group tomography_properties_group_;					/*!< group for parameters*/
@@ -77,6 +90,12 @@ class Fl_TomographyExecution : public Fl_Group{
 	Fl_Counter scattering_absorption_factor_input_;	/*!< input for absorption factor*/
 	Fl_Toggle_Button use_simple_absorption_button_;	/*!< simple or "real" absorption*/
 	Fl_Counter simulation_quality_input_;						/*!<input for simulation quality*/
+	Fl_Toggle_Button forced_detection_button_;			/*!< toggle forced detection of scattered photons*/
+	Fl_Counter max_rays_per_iteration_input_;				/*!< input for the maximum amount of scattered rays per iteration*/
+	Fl_BoundInput<Fl_Int_Input, size_t> random_seed_input_;	/*!< input for the seed of random numbers*/
+	Fl_Toggle_Button quasi_random_button_;					/*!< toggle quasi random sampling*/
+	Fl_Toggle_Button scatter_kernel_button_;				/*!< toggle approximated scattering with kernels*/
+	Fl_Toggle_Button split_projections_button_;			/*!< toggle recording of split projections*/
 
 	Fl_Multiline_Output information_;				/*!< information about tomography*/
 	
@@ -84,27 +103,65 @@ class Fl_TomographyExecution : public Fl_Group{
 	Fl_Input name_input_;										/*!< input for identifiaction name*/
 	Fl_Button record_slice_button_;					/*!< start button for radiation*/
 	Fl_Button export_projections_button_;		/*!< export button for projections*/
+
+	Fl_Group jobs_group_;										/*!< group for running and queued recordings*/
+	Fl_GrayscaleImage preview_image_;				/*!< projections of the running recording*/
+	Fl_Box job_status_;											/*!< status of recordings*/
+	Fl_Button stop_job_button_;							/*!< button to stop the running recording*/
 	
 	Fl_MainWindow& main_window_;						/*!< reference to main window*/
 
 	PersistingObject<FileChooser> export_projections_file_chooser_;		/*!< file chooser for projections export*/
 
 	PersistingObject<TomographyProperties> tomography_properties_;		/*!< parameter of tomography*/
-	Tomography tomography_;																						/*!< instance of the tomography*/
 	PersistingObject<Projections> projections_;												/*!< latest projections*/
+
+	std::unique_ptr<TomographyJob> running_job_;											/*!< recording running in the background*/
+	std::deque<TomographyProperties> queued_jobs_;										/*!< properties of recordings waiting for the running one*/
+	size_t shown_preview_revision_;																		/*!< revision of the shown preview*/
 	
 	vector<std::unique_ptr<Fl_ProcessingWindow>> processing_windows_;	/*!< collection of opened processing windows*/
  
 	CallbackFunction<Fl_TomographyExecution> record_slice_callback_;				/*!< callback for slice recording*/
 	CallbackFunction<Fl_TomographyExecution> update_properties_callback_;		/*!< callback for propertiy update*/
 	CallbackFunction<Fl_TomographyExecution> export_projections_callback_;	/*!< callback for projection export*/
+	CallbackFunction<Fl_TomographyExecution> stop_job_callback_;						/*!< callback to stop the running recording*/
 
 
 	/*!
-	 * @brief do tomography
+	 * @brief queue a recording with the current properties
+	 * @details starts the recording when no other is running
 	*/
 	void DoTomography( void );
 
+	/*!
+	 * @brief start the next queued recording
+	 * @details gantry and model are locked while recordings run
+	*/
+	void StartNextJob( void );
+
+	/*!
+	 * @brief stop the running recording
+	 * @details queued recordings start afterwards
+	*/
+	void StopJob( void );
+
+	/*!
+	 * @brief update preview and status. Takes the results of a finished recording
+	*/
+	void UpdateJob( void );
+
+	/*!
+	 * @brief update the status text
+	*/
+	void UpdateJobStatus( void );
+
+	/*!
+	 * @brief timeout callback for the running recording
+	 * @param tomography_execution pointer to the tomography execution
+	*/
+	static void HandleJobTimeout( void* tomography_execution );
+
 	/*!
 	 * @brief update tomography properties
 	*/
@@ -12,6 +12,8 @@
    Includes
 *********************************************************************/
 #include <thread>
+#include <algorithm>
+#include <numeric>
 using std::ref;
 using std::cref;
 
@@ -69,9 +71,11 @@ void Gantry::TransmitRaysThreaded(
 							 const RayScattering& ray_scattering,
 							 const vector<Ray>& rays, const bool second_to_last_iteration,
 							 size_t& shared_current_ray_index, mutex& current_ray_index_mutex,
-							 vector<Ray>& rays_for_next_iteration, mutex& rays_for_next_iteration_mutex,
+							 vector<pair<double, Ray>>& rays_for_next_iteration, size_t& number_of_scattered_rays,
 							 XRayDetector& detector, mutex& detector_mutex,
-							 RandomNumberGenerator& dedicated_rng ){
+							 const size_t frame_index, const size_t iteration, const ProgressToken* const progress_token ){
+
+	const size_t max_number_of_rays = tomography_properties.max_rays_per_iteration;
 
 	size_t local_ray_index;
 	Ray current_ray;
@@ -88,9 +92,21 @@ void Gantry::TransmitRaysThreaded(
 		// no more rays left
 		if( local_ray_index >= rays.size() ) break;
 
+		// transmission was stopped
+		if( progress_token != nullptr && progress_token->stop_requested() ) break;
+
 		// get current ray
 		current_ray =  rays.at( local_ray_index );
 
+		// random numbers only depend on seed, frame and ray
+		RandomNumberGenerator dedicated_rng{ tomography_properties.random_seed, 
+			RandomNumberGenerator::CombineIdentifiers( frame_index, current_ray.properties().identifier() ) };
+		
+		// primary rays are points of the frame's quasi random sequence. Scattered rays use pseudo random numbers
+		if( tomography_properties.quasi_random_sampling && iteration == 0 )
+			dedicated_rng.EnableQuasiRandom( RandomNumberGenerator::CombineIdentifiers( tomography_properties.random_seed, frame_index ),
+																			 current_ray.properties().identifier() );
+
 		// transmit ray through model
 		rays_to_return = std::move( 
 			model.TransmitRay( cref( current_ray ), cref( tomography_properties ), 
@@ -104,28 +120,35 @@ void Gantry::TransmitRaysThreaded(
 			continue;
 		}
 
-		// check if this is last iteration and delete rays which can not be detected
-		if( second_to_last_iteration ){
-			
-			// check each ray
-			for( auto& ray : rays_to_return.second ){
-				// detection possible. ray's expected pixel index is updated in TryDetection()
-				if( detector.TryDetection( ray ) ){
-					// only rays which can be detected are in the next iteration
-					rays_for_next_iteration_mutex.lock();
-					rays_for_next_iteration.emplace_back( std::move( ray ) );									
-					rays_for_next_iteration_mutex.unlock();
-				}
+		// returned rays are scattering sources. their contribution is detected directly
+		if( tomography_properties.forced_detection ){
+			for( const Ray& scattering_source : rays_to_return.second ){
+				DetectScatteringForced( model, tomography_properties, ray_scattering, 
+																scattering_source, detector, detector_mutex, dedicated_rng );
 			}
+			continue;
 		}
-		else{
-			// add all rays for next iteration
-			rays_for_next_iteration_mutex.lock();
-			rays_for_next_iteration.insert( 
-				rays_for_next_iteration.end(), 
-				make_move_iterator( rays_to_return.second.begin() ), 
-				make_move_iterator( rays_to_return.second.end() ) );									
-			rays_for_next_iteration_mutex.unlock();
+
+		// sampling priorities only depend on seed, frame, iteration and the scattered ray's source
+		RandomNumberGenerator population_rng{ tomography_properties.random_seed, 
+			RandomNumberGenerator::CombineIdentifiers( RandomNumberGenerator::CombineIdentifiers( frame_index, ~static_cast<uint64_t>( iteration ) ),
+																								 current_ray.properties().identifier() ) };
+
+		for( auto& ray : rays_to_return.second ){
+
+			// in the last iteration only rays which can be detected are kept
+			if( second_to_last_iteration ){
+				// cheap test first. full test iterates all pixel when ray misses the detector
+				if( !detector.IsReachable( ray ) ) continue;
+
+				// detection possible. ray's expected pixel index is updated in TryDetection()
+				if( !detector.TryDetection( ray ) ) continue;
+			}
+
+			// the thread keeps at most the allowed amount of rays so that the memory of an iteration is bounded
+			number_of_scattered_rays++;
+			const double priority = max_number_of_rays > 0 ? population_rng.GetUniformNumber() : 0.;
+			AddToPopulation( rays_for_next_iteration, std::move( ray ), priority, max_number_of_rays );
 		}
 	
 	}
@@ -133,40 +156,109 @@ void Gantry::TransmitRaysThreaded(
 	return;
 }
 
+void Gantry::DetectScatteringForced( const Model& model, 
+																		 const TomographyProperties& tomography_properties, 
+																		 const RayScattering& ray_scattering, 
+																		 const Ray& scattering_source,
+																		 XRayDetector& detector, mutex& detector_mutex,
+																		 RandomNumberGenerator& dedicated_rng ){
+
+	const DetectorProperties detector_properties = detector.properties();
+	const vector<DetectorPixel>& pixel_array = detector.converted_pixel_array();
+
+	// iterate all pixel
+	for( size_t pixel_index = 0; pixel_index < pixel_array.size(); pixel_index++ ){
+
+		const DetectorPixel& pixel = pixel_array.at( pixel_index );
+
+		// connection from scattering point to pixel center
+		const Vector3D connection = pixel.origin() - scattering_source.origin();
+		const Unitvector3D direction{ connection };
+
+		// angle covered by the pixel's width projected perpendicular to the connection
+		const double pixel_width = pixel.parameter_1_max() - pixel.parameter_1_min();
+		const double covered_angle = pixel_width * std::abs( direction * pixel.GetNormal() ) / 
+																 connection.length();
+
+		optional<Ray> scattered_ray = 
+			scattering_source.GetForcedScatteredRay( ray_scattering, direction, covered_angle, pixel_index );
+
+		if( !scattered_ray.has_value() ) continue;
+
+		// check if anti scattering structure absorbs the ray
+		if( detector_properties.has_anti_scattering_structure &&
+				( PI / 2. - scattered_ray.value().GetAngle( pixel ) ) > 
+				detector_properties.max_angle_allowed_by_structure ){
+			continue;
+		}
+
+		// attenuate photons on their way to the pixel
+		pair<Ray, vector<Ray>> transmitted_rays = 
+			model.TransmitRay( scattered_ray.value(), tomography_properties, ray_scattering, 
+												 dedicated_rng, true );
+		
+		detector.DetectRay( transmitted_rays.first, detector_mutex );
+	}
+}
+
 void Gantry::RadiateModel( const Model& model, 
 													 TomographyProperties tomography_properties,
-													 const RayScattering& scattering_information ) {
+													 const RayScattering& scattering_information,
+													 const vector<bool>& radiated_pixel,
+													 const size_t frame_index ) {
+
+	RadiationFrame frame = GetRadiationFrame( model, radiated_pixel );
+
+	// store for information output
+	tomography_properties.mean_energy_of_tube = this->tube_.GetMeanEnergy();
+
+	RadiateFrame( frame, model, tomography_properties, scattering_information, frame_index, 
+								GetNumberOfThreads() );
+
+	detector_ = std::move( frame.detector );
+}
+
+RadiationFrame Gantry::GetRadiationFrame( const Model& model, const vector<bool>& radiated_pixel ) const{
 
 	// current rays. start with rays from source
 	vector<Ray> rays = 
 		tube_.GetEmittedBeam( 
 			detector_.pixel_array(), 
-			detector_.properties().detector_focus_distance ) ;		
+			detector_.properties().detector_focus_distance,
+			radiated_pixel ) ;		
 	
-	// convert rays to model's coordinate system
-	for( Ray& current_ray : rays ){
-		current_ray = std::move( current_ray.ConvertTo( model.coordinate_system() ) );
+	// convert rays to model's coordinate system and identify them by their index
+	for( size_t ray_index = 0; ray_index < rays.size(); ray_index++ ){
+		rays.at( ray_index ) = std::move( rays.at( ray_index ).ConvertTo( model.coordinate_system() ) );
+		rays.at( ray_index ).SetIdentifier( ray_index );
 	}
 	
 	// convert pixel
-	detector_.ConvertPixelArray( model.coordinate_system() );
+	XRayDetector frame_detector = detector_;
+	frame_detector.ConvertPixelArray( model.coordinate_system() );
+	frame_detector.ResetDetectedRayPorperties(); // reset all pixel
 
-	// scattered rays should lie in the same plane as the detector 
-	// const Unitvector3D scattering_rotation_axis = 
-	// this->coordinate_system_->GetEz().ConvertTo( model.coordinate_system() );
+	return RadiationFrame{ std::move( rays ), frame_detector };
+}
 
+void Gantry::RadiateFrame( RadiationFrame& frame, const Model& model, 
+													 TomographyProperties tomography_properties,
+													 const RayScattering& scattering_information,
+													 const size_t frame_index,
+													 const size_t number_of_threads,
+													 const ProgressToken* const progress_token ){
 
-	detector_.ResetDetectedRayPorperties(); // reset all pixel
+	vector<Ray>& rays = frame.rays;
 
 	size_t shared_current_ray_index = 0;	// index of next ray to iterate
 	mutex current_ray_index_mutex;				// mutual exclusion for ray index
-	mutex rays_for_next_iteration_mutex;	// mutual exclusion for ray storage
 	mutex detector_mutex;									// mutual exclusion for detector
+	const size_t number_of_used_threads = ForceToMin1( number_of_threads );
 
 	// loop until maximum loop depth is reached or no more rays are left to transmit
 	for( size_t current_iteration = 0; 
 							current_iteration <= tomography_properties.max_scattering_occurrences && 
-														 rays.size() > 0; 
+														 rays.size() > 0 && ( progress_token == nullptr || !progress_token->stop_requested() ); 
 							current_iteration++ ){
 
 		// no scattering in last iteration
@@ -177,20 +269,15 @@ void Gantry::RadiateModel( const Model& model,
 		const bool second_to_last_iteration = 
 			( current_iteration == tomography_properties.max_scattering_occurrences - 1 );
 
-		// store for information output
-		tomography_properties.mean_energy_of_tube = this->tube_.GetMeanEnergy();
-
-		vector<Ray> rays_for_next_iteration;				// rays to process in the next iteration
+		// rays to process in the next iteration found by each thread
+		vector<vector<pair<double, Ray>>> rays_for_next_iteration( number_of_used_threads );
+		vector<size_t> number_of_scattered_rays( number_of_used_threads, 0 );
 		shared_current_ray_index = 0;								// reset current ray index
 
-		const size_t number_of_threads = std::thread::hardware_concurrency();
-
-		vector<RandomNumberGenerator> dedicated_rngs( number_of_threads );
-
 		// start threads
 		vector<std::thread> threads;
 		for( size_t thread_index = 0; 
-								thread_index < number_of_threads; thread_index++ ){
+								thread_index < number_of_used_threads; thread_index++ ){
 
 			// transmit rays
 			threads.emplace_back( TransmitRaysThreaded,	
@@ -198,10 +285,10 @@ void Gantry::RadiateModel( const Model& model,
 														cref( scattering_information ),
 														cref( rays ),  second_to_last_iteration,
 														ref( shared_current_ray_index ), 
-														ref( current_ray_index_mutex ), ref( rays_for_next_iteration ), 
-														ref( rays_for_next_iteration_mutex ),
-														ref( detector_ ), ref( detector_mutex ),
-														ref( dedicated_rngs.at( thread_index ) ) );
+														ref( current_ray_index_mutex ), ref( rays_for_next_iteration.at( thread_index ) ), 
+														ref( number_of_scattered_rays.at( thread_index ) ),
+														ref( frame.detector ), ref( detector_mutex ),
+														frame_index, current_iteration, progress_token );
 
 			// for debugging
 			if( thread_index == 0 ) first_thread_id = threads.back().get_id();
@@ -211,7 +298,18 @@ void Gantry::RadiateModel( const Model& model,
 		// wait for threads to finish
 		for( std::thread& currentThread : threads ) currentThread.join();
 		
-		rays = std::move( rays_for_next_iteration );
+		// bound the amount of scattered rays for the next iteration
+		if( tomography_properties.max_rays_per_iteration > 0 ){
+			RandomNumberGenerator population_rng{ tomography_properties.random_seed, 
+				RandomNumberGenerator::CombineIdentifiers( frame_index, ~static_cast<uint64_t>( current_iteration ) ) };
+			rays = ControlRayPopulation( rays_for_next_iteration, std::accumulate( number_of_scattered_rays.cbegin(), number_of_scattered_rays.cend(), size_t{ 0 } ), 
+																	 tomography_properties.max_rays_per_iteration, population_rng );
+		}
+		else{
+			rays.clear();
+			for( vector<pair<double, Ray>>& thread_rays : rays_for_next_iteration )
+				for( pair<double, Ray>& ray : thread_rays ) rays.push_back( std::move( ray.second ) );
+		}
 
 	}
 }
@@ -225,3 +323,135 @@ void Gantry::ResetGantry( void ){
 	detector_.ResetDetectedRayPorperties();
 }
 
+
+bool Gantry::IsSampledBefore( const pair<double, Ray>& a, const pair<double, Ray>& b ){
+
+	if( a.first != b.first ) return a.first < b.first;
+	
+	// rays of sources with the same identifier can share priority and identifier
+	if( a.second.properties().identifier() != b.second.properties().identifier() ) 
+		return a.second.properties().identifier() < b.second.properties().identifier();
+
+	return a.second.properties().energy_spectrum().GetTotalPower() < b.second.properties().energy_spectrum().GetTotalPower();
+}
+
+void Gantry::AddToPopulation( vector<pair<double, Ray>>& population, Ray&& ray, const double priority, const size_t max_number_of_rays ){
+
+	if( max_number_of_rays == 0 ){
+		population.emplace_back( priority, std::move( ray ) );
+		return;
+	}
+
+	pair<double, Ray> prioritized_ray{ priority, std::move( ray ) };
+
+	if( population.size() < max_number_of_rays ){
+		population.push_back( std::move( prioritized_ray ) );
+		std::push_heap( population.begin(), population.end(), IsSampledBefore );
+		return;
+	}
+
+	// replace the ray sampled last
+	if( !IsSampledBefore( prioritized_ray, population.front() ) ) return;
+
+	std::pop_heap( population.begin(), population.end(), IsSampledBefore );
+	population.back() = std::move( prioritized_ray );
+	std::push_heap( population.begin(), population.end(), IsSampledBefore );
+}
+
+vector<Ray> Gantry::ControlRayPopulation( vector<vector<pair<double, Ray>>>& populations, const size_t number_of_scattered_rays, 
+																					const size_t max_number_of_rays, RandomNumberGenerator& rng ){
+
+	// the rays sampled first of all rays. The order of rays does not depend on threads
+	vector<pair<double, Ray>> sampled_rays;
+	for( vector<pair<double, Ray>>& population : populations ){
+		sampled_rays.insert( sampled_rays.end(), make_move_iterator( population.begin() ), make_move_iterator( population.end() ) );
+		population.clear();
+	}
+	
+	std::sort( sampled_rays.begin(), sampled_rays.end(), IsSampledBefore );
+	if( sampled_rays.size() > max_number_of_rays ) sampled_rays.resize( max_number_of_rays );
+
+	vector<Ray> rays;
+	rays.reserve( sampled_rays.size() );
+	for( pair<double, Ray>& sampled_ray : sampled_rays ) rays.push_back( std::move( sampled_ray.second ) );
+	sampled_rays.clear();
+
+	if( rays.empty() ) return rays;
+
+	// each ray is sampled with the propability of the kept fraction
+	if( number_of_scattered_rays > rays.size() ){
+		const double sampling_propability = static_cast<double>( rays.size() ) / static_cast<double>( number_of_scattered_rays );
+		for( Ray& ray : rays ) ray.ScaleSpectrumEvenly( 1. / sampling_propability );
+	}
+
+	// power of each ray and mean power
+	vector<double> ray_powers;
+	ray_powers.reserve( rays.size() );
+	double power_sum = 0.;
+	
+	for( const Ray& ray : rays ){
+		ray_powers.push_back( ray.properties().energy_spectrum().GetTotalPower() );
+		power_sum += ray_powers.back();
+	}
+
+	const double mean_power = power_sum / static_cast<double>( rays.size() );
+	if( mean_power <= 0. ) return rays;
+
+	vector<Ray> controlled_rays;
+	controlled_rays.reserve( rays.size() );
+
+	// weight window around the mean power
+	for( size_t ray_index = 0; ray_index < rays.size(); ray_index++ ){
+
+		Ray& ray = rays.at( ray_index );
+		const double relative_power = ray_powers.at( ray_index ) / mean_power;
+
+		// russian roulette
+		if( relative_power < russian_roulette_weight ){
+			
+			const double survival_propability = relative_power / russian_roulette_survival_weight;
+			if( !rng.DidARandomEventHappen( survival_propability ) ) continue;
+
+			ray.ScaleSpectrumEvenly( 1. / survival_propability );
+			controlled_rays.push_back( std::move( ray ) );
+		}
+		// splitting
+		else if( relative_power > splitting_weight ){
+
+			const size_t number_of_splits = 
+				std::min( static_cast<size_t>( ceil( relative_power ) ), max_splitting_number );
+			
+			ray.ScaleSpectrumEvenly( 1. / static_cast<double>( number_of_splits ) );
+			const uint64_t identifier = ray.properties().identifier();
+			
+			// split rays need their own random numbers
+			for( size_t split_index = 0; split_index < number_of_splits; split_index++ ){
+				ray.SetIdentifier( RandomNumberGenerator::CombineIdentifiers( identifier, split_index ) );
+				controlled_rays.push_back( ray );
+			}
+		}
+		else{
+			controlled_rays.push_back( std::move( ray ) );
+		}
+	}
+
+	// bound the amount of rays
+	if( controlled_rays.size() > max_number_of_rays ){
+
+		const double survival_propability = 
+			static_cast<double>( max_number_of_rays ) / static_cast<double>( controlled_rays.size() );
+
+		vector<Ray> surviving_rays;
+		surviving_rays.reserve( max_number_of_rays + max_number_of_rays / 10 );
+
+		for( Ray& ray : controlled_rays ){
+			if( !rng.DidARandomEventHappen( survival_propability ) ) continue;
+			ray.ScaleSpectrumEvenly( 1. / survival_propability );
+			surviving_rays.push_back( std::move( ray ) );
+		}
+
+		controlled_rays = std::move( surviving_rays );
+	}
+
+	return controlled_rays;
+}
@@ -24,6 +24,7 @@ using std::mutex;
 #include "xRayDetector.h"
 #include "model.h"
 #include "rayScattering.h"
+#include "progressToken.h"
 #include "tomography.fwd.h"
 
 
@@ -31,6 +32,29 @@ using std::mutex;
    Definitions
 *********************************************************************/
 
+/*!
+ * @brief class for the rays and the detector of a single frame
+ * @details rays and converted pixel are in the model's coordinate system. Transmitting a frame does not 
+ * depend on the gantry's coordinate system, so frames can be radiated independently of the gantry's current position
+*/
+class RadiationFrame{
+
+	public:
+
+	/*!
+	 * @brief constructor
+	 * @param rays rays emitted by the tube
+	 * @param detector detector with pixel converted to the model's system
+	*/
+	RadiationFrame( vector<Ray> rays, const XRayDetector detector ) :
+		rays( std::move( rays ) ), detector( detector ){};
+
+
+	vector<Ray> rays;					/*!< rays to transmit*/
+	XRayDetector detector;		/*!< detector of this frame*/
+};
+
+
 /*!
  * @brief class for a gantry with xRay source and detector
 */
@@ -104,9 +128,35 @@ class Gantry{
 	 * @param model model to radiate
 	 * @param tomography_properties tomogrpahy properties
 	 * @param scattering_information scattering_properties
+	 * @param radiated_pixel flags for the pixel whose rays are emitted by the tube. All pixel are radiated when empty
+	 * @param frame_index index of the frame. selects the random number streams together with the seed
 	*/
 	void RadiateModel( const Model& model, TomographyProperties tomography_properties,
-										 const RayScattering& scattering_information) ;
+										 const RayScattering& scattering_information,
+										 const vector<bool>& radiated_pixel = vector<bool>{},
+										 const size_t frame_index = 0 );
+
+	/*!
+	 * @brief get the rays and the detector of the current position
+	 * @param model model to radiate
+	 * @param radiated_pixel flags for the pixel whose rays are emitted by the tube. All pixel are radiated when empty
+	 * @return frame in the model's coordinate system
+	*/
+	RadiationFrame GetRadiationFrame( const Model& model, const vector<bool>& radiated_pixel = vector<bool>{} ) const;
+
+	/*!
+	 * @brief radiate model with the rays of a frame
+	 * @param frame frame to radiate. The results are stored in its detector
+	 * @param model model to radiate
+	 * @param tomography_properties tomogrpahy properties
+	 * @param scattering_information scattering_properties
+	 * @param frame_index index of the frame. selects the random number streams together with the seed
+	 * @param number_of_threads amount of threads transmitting the frame's rays
+	 * @param progress_token token which stops the transmission when stop is requested. The frame is incomplete then
+	*/
+	static void RadiateFrame( RadiationFrame& frame, const Model& model, TomographyProperties tomography_properties,
+														const RayScattering& scattering_information, const size_t frame_index,
+														const size_t number_of_threads, const ProgressToken* const progress_token = nullptr );
 
 	/*!
 	 * @brief reset gantry to its initial position and reset detector
@@ -132,18 +182,72 @@ class Gantry{
 	 * @param second_to_last_iteration flag to indicate that this is the last iteration
 	 * @param current_ray_index index of the next Ray in vector to transmit. Will be changed at each call
 	 * @param current_ray_index_mutex mutex instance for Ray index
-	 * @param rays_for_next_iteration reference to vector which hold the rays for the next iteration
-	 * @param rays_for_next_iteration_mutex mutex for vector with rays for next iteration 
+	 * @param rays_for_next_iteration rays for the next iteration found by this thread with their sampling priority. 
+	 * Holds at most max_rays_per_iteration rays when the population is controlled
+	 * @param number_of_scattered_rays amount of rays found by this thread including the ones not kept
 	 * @param detector reference to ray detector
 	 * @param detector_mutex mutex for the detector instance
-	 * @param dedicated_rng a dedicated RNG with exclusive access
+	 * @param frame_index index of the current frame. each ray uses its own random number stream for this frame
+	 * @param iteration current iteration. Selects the random number streams of the sampling priorities
+	 * @param progress_token token which stops the transmission when stop is requested
 	*/
 	static void TransmitRaysThreaded(	const Model& model,	const TomographyProperties& tomography_properties, 
 										const RayScattering& ray_scattering, 
 										const vector<Ray>& rays, const bool second_to_last_iteration,
 										size_t& current_ray_index,				mutex& current_ray_index_mutex,
-										vector<Ray>& rays_for_next_iteration,	mutex& rays_for_next_iteration_mutex,
+										vector<pair<double, Ray>>& rays_for_next_iteration, size_t& number_of_scattered_rays,
 										XRayDetector& detector,					mutex& detector_mutex,
-										RandomNumberGenerator& dedicated_rng);
+										const size_t frame_index, const size_t iteration, const ProgressToken* const progress_token );
+
+	/*!
+	 * @brief add the expected contribution of a scattering source to each pixel
+	 * @param model model to radiate through
+	 * @param tomography_properties properties of tomography
+	 * @param ray_scattering information about ray scattering
+	 * @param scattering_source scattering source created during forced detection
+	 * @param detector reference to ray detector
+	 * @param detector_mutex mutex for the detector instance
+	 * @param dedicated_rng a dedicated RNG with exclusive access
+	*/
+	static void DetectScatteringForced( const Model& model, const TomographyProperties& tomography_properties, 
+																			const RayScattering& ray_scattering, const Ray& scattering_source,
+																			XRayDetector& detector, mutex& detector_mutex,
+																			RandomNumberGenerator& dedicated_rng );
+
+	/*!
+	 * @brief check if a ray is sampled before another ray
+	 * @details rays are ordered by their sampling priority, identifier and power
+	 * @param a first ray with its priority
+	 * @param b second ray with its priority
+	 * @return true when a is sampled before b
+	*/
+	static bool IsSampledBefore( const pair<double, Ray>& a, const pair<double, Ray>& b );
+
+	/*!
+	 * @brief add a scattered ray to a thread's population
+	 * @details when the population is full, the ray replaces the ray sampled last if it is sampled before it. 
+	 * The population is kept as heap with the ray sampled last on top
+	 * @param population rays with their sampling priority
+	 * @param ray ray to add
+	 * @param priority uniformly distributed sampling priority of the ray
+	 * @param max_number_of_rays maximum amount of rays in the population. Zero for no limit
+	*/
+	static void AddToPopulation( vector<pair<double, Ray>>& population, Ray&& ray, const double priority, const size_t max_number_of_rays );
+
+	/*!
+	 * @brief control the amount of scattered rays with russian roulette and splitting
+	 * @details the rays sampled first of all threads' populations are kept and amplified by the inverse of their sampling propability.
+	 * Then rays with low power compared to the mean power are terminated randomly and the survivors are amplified.
+	 * Rays with high power are split into rays with lower power. When more rays than allowed remain, each ray survives with
+	 * the propability of the allowed fraction. The expected power of each ray is unchanged.
+	 * Rays are processed in sampling order so that the result does not depend on the order of detection
+	 * @param populations rays with their sampling priority found by each thread
+	 * @param number_of_scattered_rays amount of rays found by all threads including the ones not kept
+	 * @param max_number_of_rays maximum amount of rays
+	 * @param rng random number generator
+	 * @return controlled rays
+	*/
+	static vector<Ray> ControlRayPopulation( vector<vector<pair<double, Ray>>>& populations, const size_t number_of_scattered_rays, 
+																					 const size_t max_number_of_rays, RandomNumberGenerator& rng );
 
 };
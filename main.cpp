@@ -69,8 +69,10 @@ int main( void ){
 	//VerifyHardening();
 	//VerifyScattering();
 	//verifyRNG();
+	//VerifyPrimaryTransportCache();
 
 	//VerifyFilteredprojections();
+	//VerifyFanBeamReconstruction();
 	//VerifyCupping();
 	return 0;
 
@@ -24,6 +24,7 @@ using std::cref;
 #include "propabilityDistribution.h"
 #include "tomography.h"
 #include "serialization.h"
+#include "simulation.h"
 
 
   /*********************************************************************
@@ -49,7 +50,9 @@ Model::Model( CoordinateSystem* const coordinate_system, const Index3D number_of
 	min_absorption_( default_data.GetAbsorptionAtReferenceEnergy() ),
 	max_absorption_( default_data.GetAbsorptionAtReferenceEnergy() ),
 	name_( name ),
-	voxel_data_( number_of_voxel_, default_data )
+	voxel_data_( number_of_voxel_, default_data ),
+	fingerprint_( 0 ),
+	is_fingerprint_valid_( false )
 {
 	if( coordinate_system_->IsGlobal() ) CheckForAndOutputError( MathError::Input, "model coordinate system must be child of global system!" );
 }
@@ -66,7 +69,9 @@ Model::Model( const vector<char>& binary_data, vector<char>::const_iterator& cur
 	min_absorption_( DeSerializeBuildIn<double>( 0., binary_data, current_byte ) ),
 	max_absorption_(  DeSerializeBuildIn<double>( 1., binary_data, current_byte )  ),
 	name_( DeSerializeBuildIn<string>( string{ "Default model name"}, binary_data, current_byte ) ),
-	voxel_data_( number_of_voxel_, VoxelData{} )
+	voxel_data_( number_of_voxel_, VoxelData{} ),
+	fingerprint_( 0 ),
+	is_fingerprint_valid_( false )
 {
 	
 	if( number_of_voxel_ * sizeof( VoxelData ) == static_cast<size_t>( binary_data.end() - current_byte ) ){
@@ -100,6 +105,7 @@ VoxelData Model::GetVoxelData( const Index3D voxel_indices ) const{
 }
 
 VoxelData& Model::operator()( const Index3D voxel_indices ){
+	is_fingerprint_valid_ = false;
 	if( !AreIndicesValid( voxel_indices ) ){ 
 		CheckForAndOutputError( MathError::Input, "voxel_indices exceeds model size!" ); 
 		return voxel_data_.at( number_of_voxel_ - 1 ); 
@@ -238,6 +244,7 @@ pair<Ray, vector<Ray>> Model::TransmitRay(
 	#endif
 
 	vector<Ray> all_scattered_rays;	// vector for all scattered rays
+	ScatteringSearch scattering_search;	// search for scattering along the whole path
 
 	// the possible exit faces of voxel
 	const array<bool, ConvertToUnderlying( Voxel::Face::End )> possible_exit_faces = 
@@ -361,7 +368,7 @@ pair<Ray, vector<Ray>> Model::TransmitRay(
 														 scattering_properties,
 														 current_voxel_data, distance_in_voxel, 
 														 tomography_properties, current_point_on_ray,
-														 dedicated_rng );
+														 scattering_search, dedicated_rng );
 
 				// append scattered rays
 				all_scattered_rays.insert( all_scattered_rays.end(), 
@@ -444,6 +451,38 @@ size_t Model::Serialize( vector<char>& binary_data ) const{
 }
 
 
+uint64_t Model::GetFingerprint( void ) const{
+
+	// models are shared between recording threads
+	static mutex fingerprint_mutex;
+	std::lock_guard<mutex> lock( fingerprint_mutex );
+
+	if( is_fingerprint_valid_ ) return fingerprint_;
+
+	uint64_t fingerprint = 0;
+	const auto add_bytes = [ &fingerprint ]( const char* const bytes, const size_t number_of_bytes ){
+		// eight bytes at once
+		for( size_t byte_index = 0; byte_index < number_of_bytes; byte_index += sizeof( uint64_t ) ){
+			uint64_t word = 0;
+			std::memcpy( &word, bytes + byte_index, Min( sizeof( uint64_t ), number_of_bytes - byte_index ) );
+			fingerprint = RandomNumberGenerator::CombineIdentifiers( fingerprint, word );
+		}
+	};
+
+	vector<char> header_data;
+	number_of_voxel_3D_.Serialize( header_data );
+	voxel_size_.Serialize( header_data );
+	SerializeBuildIn<string>( name_, header_data );
+	add_bytes( header_data.data(), header_data.size() );
+	add_bytes( reinterpret_cast<const char*>( voxel_data_.data() ), sizeof( VoxelData ) * number_of_voxel_ );
+
+	fingerprint_ = fingerprint;
+	is_fingerprint_valid_ = true;
+
+	return fingerprint_;
+}
+
+
 void Model::SliceThreaded( size_t& current_x_index, mutex& current_x_index_mutex, size_t& current_y_index, mutex& current_y_index_mutex,
 													 GridCoordinates& real_start, mutex& real_start_mutex, GridCoordinates& real_end, mutex& real_end_mutex,
 													 DataGrid<VoxelData>& slice, mutex& slice_mutex,
@@ -573,7 +612,7 @@ DataGrid<VoxelData> Model::GetSlice( const Surface slice_location, const GridInd
 	// computation in threads
 	vector<std::thread> threads;
 
-	for( size_t thread_index = 0; thread_index < std::thread::hardware_concurrency(); thread_index++ ){
+	for( size_t thread_index = 0; thread_index < GetNumberOfThreads(); thread_index++ ){
 		threads.emplace_back( SliceThreaded,	ref( current_x_index ), ref( current_x_index_mutex ), ref( current_y_index ), ref( current_y_index_mutex ),
 													ref( real_start ), ref( real_start_mutex), ref( real_end ), ref( real_end_mutex ),
 													ref( large_slice ), ref( slice_mutex ),
@@ -79,6 +79,13 @@ class Model : public MathematicalObject{
 	*/
 	size_t Serialize( vector<char>& binary_data ) const;
 
+	/*!
+	 * @brief get fingerprint of the model's data
+	 * @details computed once and kept until the voxel data change. The model's position is not part of the fingerprint
+	 * @return fingerprint
+	*/
+	uint64_t GetFingerprint( void ) const;
+
 	/*!
 	 * @brief get number of voxel
 	 * @return voxel amount
@@ -243,6 +250,8 @@ class Model : public MathematicalObject{
 	double max_absorption_;								/*!< absorption maximum in model*/			
 	string name_;													/*!< model name*/
 	vector<VoxelData> voxel_data_;				/*!< voxel data*/
+	mutable uint64_t fingerprint_;				/*!< fingerprint of the model's data*/
+	mutable bool is_fingerprint_valid_;		/*!< flag for valid fingerprint*/
 
 
 	private:
@@ -0,0 +1,444 @@
+/*********************************************************************
+ * @file   parameterSweep.cpp
+ * @brief  implementations
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include "parameterSweep.h"
+#include "coordinateSystemTree.h"
+#include "simulation.h"
+#include "serialization.h"
+#include "tomography.h"
+#include "projections.h"
+#include "filteredProjections.h"
+#include "backprojection.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+const string ParameterSweep::manifest_file_name{ "manifest.tsv" };
+
+
+ParameterSweep::ParameterSweep( const ScanConfiguration base_configuration ) :
+	base_configuration_( base_configuration )
+{}
+
+bool ParameterSweep::CheckParameters( const vector<pair<string, vector<string>>>& parameter_values, vector<string>* const invalid_parameters ) const{
+
+	bool all_valid = true;
+	for( const auto& [ name, values ] : parameter_values ){
+		for( const string& value : values ){
+			ScanConfiguration test_configuration = base_configuration_;
+			if( test_configuration.Set( name, value ) ) continue;
+
+			all_valid = false;
+			if( invalid_parameters != nullptr ) invalid_parameters->push_back( name + " = " + value );
+		}
+		if( values.empty() ){
+			all_valid = false;
+			if( invalid_parameters != nullptr ) invalid_parameters->push_back( name + " =" );
+		}
+	}
+
+	return all_valid;
+}
+
+bool ParameterSweep::AddRuns( const vector<pair<string, vector<string>>> parameter_values, vector<string>* const invalid_parameters ){
+
+	if( !CheckParameters( parameter_values, invalid_parameters ) ) return false;
+
+	for( const auto& parameter_value : parameter_values ){
+		if( std::find( parameter_names_.cbegin(), parameter_names_.cend(), parameter_value.first ) == parameter_names_.cend() )
+			parameter_names_.push_back( parameter_value.first );
+	}
+
+	// iterate all combinations like a counter with one digit per parameter
+	vector<size_t> value_indices( parameter_values.size(), 0 );
+	while( true ){
+
+		SweepRun run;
+		run.configuration = base_configuration_;
+		for( size_t parameter_index = 0; parameter_index < parameter_values.size(); parameter_index++ ){
+			const auto& [ name, values ] = parameter_values.at( parameter_index );
+			const string& value = values.at( value_indices.at( parameter_index ) );
+			run.configuration.Set( name, value );
+			run.parameters.emplace_back( name, value );
+		}
+		AddRun( std::move( run ) );
+
+		size_t digit = 0;
+		for( ; digit < value_indices.size(); digit++ ){
+			if( ++value_indices.at( digit ) < parameter_values.at( digit ).second.size() ) break;
+			value_indices.at( digit ) = 0;
+		}
+		if( digit == value_indices.size() ) break;
+	}
+
+	return true;
+}
+
+bool ParameterSweep::Load( const path file_path, vector<string>* const invalid_lines ){
+
+	std::ifstream file{ file_path };
+	if( !file.is_open() ) return false;
+
+	const auto trim = []( const string text ){
+		const size_t start = text.find_first_not_of( " \t\r" );
+		if( start == string::npos ) return string{};
+		return text.substr( start, text.find_last_not_of( " \t\r" ) - start + 1 );
+	};
+
+	// parameters for all runs and parameters of each run section
+	vector<pair<string, vector<string>>> common_parameters;
+	vector<vector<pair<string, vector<string>>>> run_sections;
+
+	bool all_valid = true;
+	string line;
+	while( std::getline( file, line ) ){
+
+		const string trimmed_line = trim( line );
+		if( trimmed_line.empty() || trimmed_line.front() == '#' ) continue;
+
+		if( trimmed_line == "[run]" ){
+			run_sections.emplace_back();
+			continue;
+		}
+
+		const size_t separator = trimmed_line.find( '=' );
+		if( separator == string::npos ){
+			all_valid = false;
+			if( invalid_lines != nullptr ) invalid_lines->push_back( trimmed_line );
+			continue;
+		}
+
+		vector<string> values;
+		std::stringstream value_stream{ trimmed_line.substr( separator + 1 ) };
+		for( string value; std::getline( value_stream, value, ',' ); ) values.push_back( trim( value ) );
+
+		vector<pair<string, vector<string>>>& section = run_sections.empty() ? common_parameters : run_sections.back();
+		section.emplace_back( trim( trimmed_line.substr( 0, separator ) ), values );
+	}
+
+	if( run_sections.empty() ) run_sections.emplace_back();
+
+	// run sections override common parameters
+	vector<vector<pair<string, vector<string>>>> section_parameters;
+	for( const auto& run_section : run_sections ){
+		vector<pair<string, vector<string>>> parameters = common_parameters;
+		for( const auto& parameter : run_section ){
+			auto same_parameter = std::find_if( parameters.begin(), parameters.end(), [ & ]( const auto& other ){ return other.first == parameter.first; } );
+			if( same_parameter != parameters.end() ) same_parameter->second = parameter.second;
+			else parameters.push_back( parameter );
+		}
+		section_parameters.push_back( parameters );
+	}
+
+	// check all sections before adding runs
+	for( const auto& parameters : section_parameters )
+		if( !CheckParameters( parameters, invalid_lines ) ) all_valid = false;
+	if( !all_valid ) return false;
+
+	for( const auto& parameters : section_parameters ) AddRuns( parameters );
+
+	return true;
+}
+
+void ParameterSweep::AddRun( SweepRun run ){
+
+	// identical runs are executed once
+	const vector<char> run_data = GetConfigurationData( run.configuration, true, true );
+	if( std::find( run_data_.cbegin(), run_data_.cend(), run_data ) != run_data_.cend() ) return;
+
+	const size_t run_index = runs_.size();
+
+	// runs differing only in reconstruction share the recording
+	const vector<char> acquisition_data = GetConfigurationData( run.configuration, false, true );
+	const auto same_acquisition = std::find( acquisition_data_.cbegin(), acquisition_data_.cend(), acquisition_data );
+	run.acquisition_index = static_cast<size_t>( same_acquisition - acquisition_data_.cbegin() );
+
+	if( same_acquisition == acquisition_data_.cend() ){
+		acquisitions_.emplace_back();
+		acquisition_data_.push_back( acquisition_data );
+
+		// without traced scattering the primary transport does not depend on the scattering parameters
+		const TomographyProperties& tomography_properties = run.configuration.tomography_properties;
+		const bool traces_scattering = tomography_properties.scattering_enabled && tomography_properties.max_scattering_occurrences > 0 &&
+																	 !tomography_properties.scatter_kernel_mode;
+
+		// transports for scatter kernels contain all pixel
+		vector<char> transport_data = GetConfigurationData( run.configuration, false, traces_scattering );
+		SerializeBuildIn<bool>( tomography_properties.scatter_kernel_mode && tomography_properties.scattering_enabled && 
+														tomography_properties.max_scattering_occurrences > 0, transport_data );
+		const auto same_transport = std::find( transport_data_.cbegin(), transport_data_.cend(), transport_data );
+
+		if( traces_scattering || same_transport == transport_data_.cend() ){
+			transports_.push_back( { run.acquisition_index } );
+			transport_data_.push_back( transport_data );
+		}
+		else
+			transports_.at( static_cast<size_t>( same_transport - transport_data_.cbegin() ) ).push_back( run.acquisition_index );
+	}
+
+	acquisitions_.at( run.acquisition_index ).push_back( run_index );
+	run_data_.push_back( run_data );
+	runs_.push_back( std::move( run ) );
+}
+
+bool ParameterSweep::Execute( const Model& model, const path output_directory, const size_t number_of_parallel_runs,
+															ProgressToken* const progress_token ){
+
+	if( runs_.empty() ) return true;
+
+	std::error_code error_code;
+	std::filesystem::create_directories( output_directory, error_code );
+	if( error_code ) return false;
+
+	if( progress_token != nullptr ) progress_token->SetTotal( runs_.size() );
+
+	// the global simulation properties are shared by all recordings.
+	// Only transports with the same simulation quality and z-position can run at the same time
+	std::map<pair<size_t, double>, vector<size_t>> transport_groups;
+	for( size_t transport_index = 0; transport_index < transports_.size(); transport_index++ ){
+		const ScanConfiguration& configuration = runs_.at( acquisitions_.at( transports_.at( transport_index ).front() ).front() ).configuration;
+		const size_t simulation_quality = SimulationProperties{ configuration.tomography_properties.simulation_quality }.quality;
+		transport_groups[ { simulation_quality, configuration.z_position } ].push_back( transport_index );
+	}
+
+	const size_t number_of_threads = GetNumberOfThreads();
+	const size_t requested_parallel_runs = number_of_parallel_runs > 0 ? number_of_parallel_runs :
+																					ForceToMin1( number_of_threads / threads_per_run );
+	size_t largest_group_size = 0;
+	for( const auto& transport_group : transport_groups ) largest_group_size = std::max( largest_group_size, transport_group.second.size() );
+	const size_t number_of_workers = std::min( requested_parallel_runs, largest_group_size );
+
+	// one gantry and radon coordinate system per worker. Coordinate systems are added before the workers start because the tree is not thread safe
+	SetSimulationQuality( transport_groups.cbegin()->first.first );
+	vector<Gantry> gantries;
+	vector<CoordinateSystem*> radon_coordinate_systems;
+	for( size_t worker_index = 0; worker_index < number_of_workers; worker_index++ ){
+		gantries.push_back( base_configuration_.CreateGantry( GetCoordinateSystemTree().AddSystem( "Sweep gantry system " + to_string( worker_index ) ) ) );
+		radon_coordinate_systems.push_back( GetCoordinateSystemTree().AddSystem( "Sweep radon system " + to_string( worker_index ) ) );
+	}
+
+	vector<ProgressToken> run_tokens( number_of_workers );
+
+	for( const auto& [ group_key, group_transports ] : transport_groups ){
+
+		if( progress_token != nullptr && progress_token->stop_requested() ) break;
+
+		SetSimulationQuality( group_key.first );
+
+		// longest first so that short transports fill the gaps at the end
+		vector<pair<double, size_t>> transport_efforts;
+		for( const size_t transport_index : group_transports ){
+			const vector<size_t>& transport = transports_.at( transport_index );
+			const ScanConfiguration& configuration = runs_.at( acquisitions_.at( transport.front() ).front() ).configuration;
+			const double reuse_effort = static_cast<double>( configuration.projections_properties.number_of_frames_to_fill() *
+																											 configuration.projections_properties.number_of_distances() );
+			transport_efforts.emplace_back( EstimateEffort( configuration ) + static_cast<double>( transport.size() - 1 ) * reuse_effort, transport_index );
+		}
+		std::sort( transport_efforts.begin(), transport_efforts.end(), std::greater<pair<double, size_t>>{} );
+
+		// split threads among the parallel runs
+		const size_t number_of_group_workers = std::min( number_of_workers, group_transports.size() );
+		SetNumberOfThreads( ForceToMin1( number_of_threads / number_of_group_workers ) );
+
+		std::atomic<size_t> next_transport{ 0 };
+		std::atomic<size_t> number_of_active_workers{ number_of_group_workers };
+		vector<std::thread> workers;
+
+		for( size_t worker_index = 0; worker_index < number_of_group_workers; worker_index++ ){
+			workers.emplace_back( [ &, worker_index ]( void ){
+				for( size_t transport_position = next_transport++; transport_position < transport_efforts.size(); transport_position = next_transport++ )
+					ExecuteTransport( transport_efforts.at( transport_position ).second, gantries.at( worker_index ), 
+														radon_coordinate_systems.at( worker_index ), model, output_directory, run_tokens.at( worker_index ), progress_token );
+				--number_of_active_workers;
+			} );
+		}
+
+		// forward stop requests to the runs
+		while( number_of_active_workers.load() > 0 ){
+			std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+			if( progress_token != nullptr && progress_token->stop_requested() )
+				for( ProgressToken& run_token : run_tokens ) run_token.RequestStop();
+		}
+
+		for( std::thread& worker : workers ) worker.join();
+	}
+
+	SetNumberOfThreads( number_of_threads );
+
+	for( SweepRun& run : runs_ ) if( run.status == "pending" ) run.status = "stopped";
+
+	const bool manifest_exported = ExportManifest( output_directory );
+
+	return manifest_exported &&
+		std::all_of( runs_.cbegin(), runs_.cend(), []( const SweepRun& run ){ return run.status == "done"; } );
+}
+
+void ParameterSweep::ExecuteTransport( const size_t transport_index, Gantry& gantry, CoordinateSystem* const radon_coordinate_system, 
+																			 const Model& model, const path output_directory, ProgressToken& run_token, ProgressToken* const progress_token ){
+
+	const auto export_object = [ & ]( const auto& object, const string file_name ){
+		vector<char> binary_data;
+		SerializeBuildIn<string>( std::remove_cvref_t<decltype( object )>::FILE_PREAMBLE, binary_data );
+		object.Serialize( binary_data );
+		return ExportSerialized( output_directory / file_name, binary_data );
+	};
+	const auto seconds_since = []( const std::chrono::steady_clock::time_point start ){
+		return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count(); };
+
+	// recordings after the first reuse the primary transport cached by the tomography. 
+	// It is held until all recordings are done so that concurrent recordings do not remove it from the cache
+	vector<std::shared_ptr<const vector<vector<PixelDetection>>>> held_primary_transports;
+
+	for( const size_t acquisition_index : transports_.at( transport_index ) ){
+
+		const vector<size_t>& run_indices = acquisitions_.at( acquisition_index );
+		const ScanConfiguration& configuration = runs_.at( run_indices.front() ).configuration;
+
+		configuration.UpdateGantry( gantry );
+		TomographyProperties tomography_properties = configuration.tomography_properties;
+		tomography_properties.mean_energy_of_tube = gantry.tube().GetMeanEnergy();
+		tomography_properties.filter_active = gantry.tube().properties().has_filter_;
+
+		try{
+			if( run_token.stop_requested() ) return;
+
+			const auto recording_start = std::chrono::steady_clock::now();
+			Tomography tomography{ tomography_properties, radon_coordinate_system };
+			const optional<Projections> projections =
+				tomography.RecordSlice( configuration.projections_properties, gantry, model, configuration.z_position, &run_token );
+			const double recording_duration_s = seconds_since( recording_start );
+			held_primary_transports = tomography.primary_transports();
+
+			if( !projections.has_value() ) return;
+
+			const string projections_file = "run_" + to_string( run_indices.front() ) + ".projections";
+			const bool projections_exported = export_object( projections.value(), projections_file );
+
+			for( const size_t run_index : run_indices ){
+
+				SweepRun& run = runs_.at( run_index );
+				run.recording_duration_s = recording_duration_s;
+				if( projections_exported ) run.projections_file = projections_file;
+
+				const auto reconstruction_start = std::chrono::steady_clock::now();
+				const FilteredProjections filtered_projections{ projections.value(), run.configuration.filter_type, &run_token };
+				if( run_token.stop_requested() ) return;
+				const Backprojection backprojection{ filtered_projections, &run_token };
+				if( run_token.stop_requested() ) return;
+				run.reconstruction_duration_s = seconds_since( reconstruction_start );
+
+				const string backprojection_file = "run_" + to_string( run_index ) + ".backprojection";
+				const bool backprojection_exported = export_object( backprojection, backprojection_file );
+				if( backprojection_exported ) run.backprojection_file = backprojection_file;
+
+				run.status = projections_exported && backprojection_exported ? "done" : "failed";
+				if( progress_token != nullptr ){
+					progress_token->Advance();
+					progress_token->SetLine( 0, "Finished " + to_string( progress_token->completed_steps() ) + " of " +
+																			to_string( runs_.size() ) + " runs" );
+				}
+			}
+		}
+		catch( const std::exception& ){
+			for( const size_t run_index : run_indices )
+				if( runs_.at( run_index ).status == "pending" ) runs_.at( run_index ).status = "failed";
+		}
+	}
+}
+
+bool ParameterSweep::ExportManifest( const path output_directory ) const{
+
+	std::ofstream manifest{ output_directory / manifest_file_name };
+	if( !manifest.is_open() ) return false;
+
+	manifest << "run\tstatus\trecording_s\treconstruction_s\tprojections\tbackprojection";
+	for( const string& parameter_name : parameter_names_ ) manifest << "\t" << parameter_name;
+	manifest << "\n";
+
+	for( size_t run_index = 0; run_index < runs_.size(); run_index++ ){
+		const SweepRun& run = runs_.at( run_index );
+
+		manifest << run_index << "\t" << run.status << "\t" << run.recording_duration_s << "\t" << run.reconstruction_duration_s << "\t" <<
+			run.projections_file << "\t" << run.backprojection_file;
+
+		for( const string& parameter_name : parameter_names_ ){
+			const auto parameter = std::find_if( run.parameters.cbegin(), run.parameters.cend(),
+																					 [ & ]( const auto& parameter ){ return parameter.first == parameter_name; } );
+			manifest << "\t" << ( parameter != run.parameters.cend() ? parameter->second : string{} );
+		}
+		manifest << "\n";
+	}
+
+	return manifest.good();
+}
+
+vector<char> ParameterSweep::GetConfigurationData( const ScanConfiguration& configuration, const bool with_reconstruction,
+																									 const bool with_scattering ){
+
+	ScanConfiguration reduced_configuration = configuration;
+	TomographyProperties& tomography_properties = reduced_configuration.tomography_properties;
+	const TomographyProperties default_properties{};
+
+	// tube dependent values are set for each recording
+	tomography_properties.mean_energy_of_tube = default_properties.mean_energy_of_tube;
+	tomography_properties.filter_active = default_properties.filter_active;
+
+	// the name only identifies the results
+	if( !with_reconstruction ){
+		reduced_configuration.filter_type = BackprojectionFilter::TYPE::ramLak;
+		tomography_properties.name = default_properties.name;
+	}
+
+	if( !with_scattering ){
+		tomography_properties.scattering_enabled = default_properties.scattering_enabled;
+		tomography_properties.max_scattering_occurrences = default_properties.max_scattering_occurrences;
+		tomography_properties.scatter_propability_correction = default_properties.scatter_propability_correction;
+		tomography_properties.scattered_ray_absorption_factor = default_properties.scattered_ray_absorption_factor;
+		tomography_properties.scatter_kernel_mode = default_properties.scatter_kernel_mode;
+	}
+
+	vector<char> binary_data;
+	SerializeBuildIn<bool>( with_scattering, binary_data );
+	reduced_configuration.tube_properties.Serialize( binary_data );
+	reduced_configuration.projections_properties.Serialize( binary_data );
+	reduced_configuration.detector_properties.Serialize( binary_data );
+	tomography_properties.Serialize( binary_data );
+	SerializeBuildIn<int>( static_cast<int>( reduced_configuration.filter_type ), binary_data );
+	SerializeBuildIn<double>( reduced_configuration.z_position, binary_data );
+
+	return binary_data;
+}
+
+double ParameterSweep::EstimateEffort( const ScanConfiguration& configuration ){
+
+	const TomographyProperties& tomography_properties = configuration.tomography_properties;
+	const bool traces_scattering = tomography_properties.scattering_enabled && tomography_properties.max_scattering_occurrences > 0 &&
+																 !tomography_properties.scatter_kernel_mode;
+
+	// rays are transmitted once per frame and pixel. Each scattering occurrence transmits the scattered rays again
+	return static_cast<double>( configuration.projections_properties.number_of_frames_to_fill() ) *
+				 static_cast<double>( configuration.projections_properties.number_of_distances() ) *
+				 static_cast<double>( configuration.tube_properties.number_of_rays_per_pixel_ ) *
+				 static_cast<double>( traces_scattering ? tomography_properties.max_scattering_occurrences + 1 : 1 );
+}
@@ -0,0 +1,178 @@
+#pragma once
+/*********************************************************************
+ * @file   parameterSweep.h
+ * @brief  classes to record and reconstruct a model with many parameter sets
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "generel.h"
+#include "scanConfiguration.h"
+#include "gantry.h"
+#include "model.h"
+#include "progressToken.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for a single run of a parameter sweep
+*/
+class SweepRun{
+
+	public:
+
+	vector<pair<string, string>> parameters;		/*!< parameters set by the sweep with their values*/
+	ScanConfiguration configuration;						/*!< configuration of the run*/
+	size_t acquisition_index = 0;								/*!< index of the recording shared with runs differing only in reconstruction*/
+	string status = "pending";									/*!< status of run. "pending", "done", "stopped" or "failed"*/
+	double recording_duration_s = 0.;						/*!< duration of the shared recording*/
+	double reconstruction_duration_s = 0.;			/*!< duration of filtering and backprojection*/
+	string projections_file;										/*!< file name of recorded projections in output directory*/
+	string backprojection_file;									/*!< file name of reconstructed image in output directory*/
+
+};
+
+
+/*!
+ * @brief class for a sweep over parameter sets
+ * @details the model is shared by all runs. Runs differing only in reconstruction parameters share their recording and recordings
+ * differing only in scattering parameters without traced scattering reuse the same primary transport. Identical runs are executed once
+*/
+class ParameterSweep{
+
+	public:
+
+	static const string manifest_file_name;						/*!< name of the manifest in the output directory*/
+	static constexpr size_t threads_per_run = 4;			/*!< amount of threads per run when the amount of parallel runs is not given*/
+
+
+	/*!
+	 * @brief constructor
+	 * @param base_configuration configuration the parameters of each run are applied to
+	*/
+	ParameterSweep( const ScanConfiguration base_configuration );
+
+	/*!
+	 * @brief add runs for each combination of parameter values
+	 * @param parameter_values names of parameters with their values
+	 * @param invalid_parameters when given "name = value" of unknown names or invalid values are written to it
+	 * @return true when all parameters are valid. No run is added otherwise
+	*/
+	bool AddRuns( const vector<pair<string, vector<string>>> parameter_values, vector<string>* const invalid_parameters = nullptr );
+
+	/*!
+	 * @brief add runs from text file
+	 * @details lines "name = value, value, ..." before the first "[run]" line are applied to all runs.
+	 * Each "[run]" line starts a set of parameters which override them. Runs are added for each combination of listed values.
+	 * Lines starting with '#' are comments
+	 * @param file_path path to file
+	 * @param invalid_lines when given invalid lines are written to it
+	 * @return true when file was read and all lines are valid. No run is added otherwise
+	*/
+	bool Load( const path file_path, vector<string>* const invalid_lines = nullptr );
+
+	/*!
+	 * @brief get runs
+	 * @return runs of sweep
+	*/
+	const vector<SweepRun>& runs( void ) const{ return runs_; };
+
+	/*!
+	 * @brief get amount of recordings
+	 * @return amount of recordings
+	*/
+	size_t number_of_acquisitions( void ) const{ return acquisitions_.size(); };
+
+	/*!
+	 * @brief get amount of primary transports
+	 * @return amount of recordings with own primary transport
+	*/
+	size_t number_of_transports( void ) const{ return transports_.size(); };
+
+	/*!
+	 * @brief record and reconstruct all runs
+	 * @details runs with the same simulation quality and z-position are executed in parallel. The threads are split among them.
+	 * Results and the manifest are written to the output directory
+	 * @param model model to record
+	 * @param output_directory directory for results
+	 * @param number_of_parallel_runs amount of runs executed at the same time. Zero to derive it from the amount of threads
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @return true when all runs are done
+	*/
+	bool Execute( const Model& model, const path output_directory, const size_t number_of_parallel_runs = 0,
+								ProgressToken* const progress_token = nullptr );
+
+
+	private:
+
+	ScanConfiguration base_configuration_;				/*!< configuration without sweep parameters*/
+	vector<string> parameter_names_;							/*!< names of parameters set by the sweep in order of appearance*/
+	vector<SweepRun> runs_;												/*!< runs*/
+	vector<vector<char>> run_data_;								/*!< serialized configuration of each run*/
+	vector<vector<size_t>> acquisitions_;					/*!< indices of runs sharing a recording*/
+	vector<vector<char>> acquisition_data_;				/*!< serialized configuration of each recording*/
+	vector<vector<size_t>> transports_;						/*!< indices of recordings sharing a primary transport*/
+	vector<vector<char>> transport_data_;					/*!< serialized configuration of each primary transport*/
+
+
+	/*!
+	 * @brief check parameter values
+	 * @param parameter_values names of parameters with their values
+	 * @param invalid_parameters when given "name = value" of unknown names or invalid values are written to it
+	 * @return true when all names are known and all values are valid
+	*/
+	bool CheckParameters( const vector<pair<string, vector<string>>>& parameter_values, vector<string>* const invalid_parameters ) const;
+
+	/*!
+	 * @brief add a run if it differs from all runs
+	 * @param run run to add
+	*/
+	void AddRun( SweepRun run );
+
+	/*!
+	 * @brief record and reconstruct the recordings sharing a primary transport
+	 * @param transport_index index of primary transport
+	 * @param gantry gantry used exclusively by the calling thread
+	 * @param radon_coordinate_system radon coordinate system used exclusively by the calling thread
+	 * @param model model to record
+	 * @param output_directory directory for results
+	 * @param run_token token to stop the runs
+	 * @param progress_token token to report finished runs. Can be null
+	*/
+	void ExecuteTransport( const size_t transport_index, Gantry& gantry, CoordinateSystem* const radon_coordinate_system, 
+												 const Model& model, const path output_directory, ProgressToken& run_token, ProgressToken* const progress_token );
+
+	/*!
+	 * @brief write manifest with status, durations, files and parameters of each run
+	 * @param output_directory directory for results
+	 * @return true at success
+	*/
+	bool ExportManifest( const path output_directory ) const;
+
+	/*!
+	 * @brief get serialized configuration
+	 * @param configuration configuration
+	 * @param with_reconstruction include reconstruction parameters and name
+	 * @param with_scattering include scattering parameters
+	 * @return serialized data
+	*/
+	static vector<char> GetConfigurationData( const ScanConfiguration& configuration, const bool with_reconstruction, const bool with_scattering );
+
+	/*!
+	 * @brief estimate the relative effort to record with a configuration
+	 * @param configuration configuration
+	 * @return relative effort
+	*/
+	static double EstimateEffort( const ScanConfiguration& configuration );
+
+};
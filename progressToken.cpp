@@ -0,0 +1,42 @@
+/*********************************************************************
+ * @file   progressToken.cpp
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "progressToken.h"
+#include "generelMath.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+ProgressToken::ProgressToken( const size_t number_of_lines ) :
+	lines_( ForceToMin1( number_of_lines ) ),
+	completed_steps_( 0 ),
+	total_steps_( 0 ),
+	revision_( 0 ),
+	stop_requested_( false )
+{}
+
+void ProgressToken::SetLine( const size_t line_number, const string line_text ){
+	
+	std::lock_guard<mutex> lock{ lines_mutex_ };
+	if( line_number >= lines_.size() ) return;
+	
+	lines_.at( line_number ) = line_text;
+	++revision_;
+}
+
+vector<string> ProgressToken::lines( void ) const{
+	std::lock_guard<mutex> lock{ lines_mutex_ };
+	return lines_;
+}
@@ -0,0 +1,115 @@
+#pragma once
+/*********************************************************************
+ * @file   progressToken.h
+ * @brief  class to report progress and request cancellation of computations
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <atomic>
+#include "generel.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class shared between a computation and its observer
+ * @details the computation writes progress and polls the stop flag. The observer reads the progress on its own schedule 
+ * and requests the computation to stop. All members are thread safe and cheap to call from compute loops
+*/
+class ProgressToken{
+
+	public:
+
+	/*!
+	 * @brief constructor
+	 * @param number_of_lines amount of text lines
+	*/
+	ProgressToken( const size_t number_of_lines = 2 );
+
+	/*!
+	 * @brief deleted
+	*/
+	ProgressToken( const ProgressToken& ) = delete;
+
+	/*!
+	 * @brief deleted
+	*/
+	ProgressToken& operator=( const ProgressToken& ) = delete;
+
+	/*!
+	 * @brief change text in a line
+	 * @param line_number line number to change. starting at 0
+	 * @param line_text new line text
+	*/
+	void SetLine( const size_t line_number, const string line_text );
+
+	/*!
+	 * @brief get the text of all lines
+	 * @return line texts
+	*/
+	vector<string> lines( void ) const;
+
+	/*!
+	 * @brief start a stage of the computation
+	 * @details completed steps are reset so that consecutive stages sharing a token each report their own progress
+	 * @param total_steps amount of steps of the stage
+	*/
+	void SetTotal( const size_t total_steps ){ 
+		completed_steps_.store( 0, std::memory_order_relaxed ); total_steps_.store( total_steps, std::memory_order_relaxed ); ++revision_; };
+
+	/*!
+	 * @brief mark steps as completed
+	 * @param steps amount of completed steps
+	*/
+	void Advance( const size_t steps = 1 ){ completed_steps_.fetch_add( steps, std::memory_order_relaxed ); ++revision_; };
+
+	/*!
+	 * @brief get amount of completed steps
+	 * @return completed steps
+	*/
+	size_t completed_steps( void ) const{ return completed_steps_.load( std::memory_order_relaxed ); };
+
+	/*!
+	 * @brief get amount of steps
+	 * @return total steps
+	*/
+	size_t total_steps( void ) const{ return total_steps_.load( std::memory_order_relaxed ); };
+
+	/*!
+	 * @brief get the revision which changes with every update
+	 * @return revision
+	*/
+	size_t revision( void ) const{ return revision_.load( std::memory_order_relaxed ); };
+
+	/*!
+	 * @brief request the computation to stop
+	*/
+	void RequestStop( void ){ stop_requested_.store( true, std::memory_order_relaxed ); };
+
+	/*!
+	 * @brief check if the computation should stop
+	 * @return true when stop was requested
+	*/
+	bool stop_requested( void ) const{ return stop_requested_.load( std::memory_order_relaxed ); };
+
+
+	private:
+
+	mutable mutex lines_mutex_;							/*!< mutual exclusion for line texts*/
+	vector<string> lines_;									/*!< line texts*/
+	std::atomic<size_t> completed_steps_;		/*!< amount of completed steps*/
+	std::atomic<size_t> total_steps_;				/*!< amount of steps*/
+	std::atomic<size_t> revision_;					/*!< counter for changes*/
+	std::atomic<bool> stop_requested_;			/*!< flag for requested stop*/
+
+};
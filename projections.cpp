@@ -28,7 +28,7 @@
 */
 
 
-const string Projections::FILE_PREAMBLE{ "Ver03RADON_TRANSFORMED_FILE_PREAMBLE" };
+const string Projections::FILE_PREAMBLE{ "Ver09RADON_TRANSFORMED_FILE_PREAMBLE" };
 
 Projections::Projections( void ) :
 	DataGrid<>{}
@@ -46,9 +46,9 @@ Projections::Projections( const ProjectionsProperties properties, const Tomograp
 	grid_errors_( vector<vector<GridCoordinates>>( size().c, vector<GridCoordinates>( size().r, GridCoordinates{ INFINITY, INFINITY } ) ) )
 {}
 
-void Projections::AssignData( const RadonPoint radon_point ){
+ProjectionsAssignment Projections::GetAssignment( const RadonCoordinates radon_coordinates ) const{
 
-	const GridCoordinates point{ radon_point.theta, radon_point.distance };
+	const GridCoordinates point{ radon_coordinates.theta, radon_coordinates.distance };
 	const GridIndex index = GetIndex( point );
 	const GridCoordinates gridPoint{ GetCoordinates( index )};
 
@@ -57,8 +57,12 @@ void Projections::AssignData( const RadonPoint radon_point ){
 		gridPoint.r - point.r
 	};
 
-	grid_errors_.at( index.c ).at( index.r ) = error;
-	this->SetData( index, radon_point.value );
+	return ProjectionsAssignment{ index, error };
+}
+
+void Projections::AssignData( const ProjectionsAssignment& assignment, const double value ){
+	grid_errors_.at( assignment.index.c ).at( assignment.index.r ) = assignment.error;
+	this->SetData( assignment.index, value );
 }
 
 
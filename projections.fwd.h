@@ -1,4 +1,5 @@
 #pragma once
 
 class ProjectionsProperties;
-class Projections;
\ No newline at end of file
+class Projections;
+class ProjectionsAssignment;
\ No newline at end of file
@@ -25,6 +25,32 @@
 *********************************************************************/
 
 
+/*!
+ * @brief class for the position of a radon point inside the projections grid
+*/
+class ProjectionsAssignment{
+
+	public:
+
+	/*!
+	 * @brief constructor
+	 * @param index index in projections grid
+	 * @param error difference between the grid point and the exact radon coordinates
+	*/
+	ProjectionsAssignment( const GridIndex index, const GridCoordinates error ) :
+		index( index ), error( error ){};
+
+	/*!
+	 * @brief default constructor
+	*/
+	ProjectionsAssignment( void ) : ProjectionsAssignment{ GridIndex{}, GridCoordinates{} }{};
+
+
+	GridIndex index;					/*!< index in projections grid*/
+	GridCoordinates error;		/*!< difference between the grid point and the exact radon coordinates*/
+};
+
+
 /*!
  * @brief class for projections data by tomography
 */
@@ -120,7 +146,21 @@ class Projections : private DataGrid<> {
 	 * @brief assign data to grid
 	 * @param radon_point data point
 	*/
-	void AssignData( const RadonPoint radon_point );
+	void AssignData( const RadonPoint radon_point ){ AssignData( GetAssignment( radon_point ), radon_point.value ); };
+
+	/*!
+	 * @brief get the position of radon coordinates in grid
+	 * @param radon_coordinates coordinates to get the assignment for
+	 * @return index and interpolation error of the coordinates
+	*/
+	ProjectionsAssignment GetAssignment( const RadonCoordinates radon_coordinates ) const;
+
+	/*!
+	 * @brief assign data to grid at precomputed position
+	 * @param assignment position in grid
+	 * @param value value to assign
+	*/
+	void AssignData( const ProjectionsAssignment& assignment, const double value );
 
 
 	private:
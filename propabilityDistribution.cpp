@@ -12,10 +12,12 @@
 *********************************************************************/
 
 #include <chrono>
+#include <algorithm>
 
 #include "generelMath.h"
 #include "propabilityDistribution.h"
 #include "vectorAlgorithm.h"
+#include "serialization.h"
 
 
 
@@ -30,37 +32,121 @@
 
 
 RandomNumberGenerator::RandomNumberGenerator( const unsigned long long int extra_seed ) :
+	RandomNumberGenerator{ CombineIdentifiers( static_cast<uint64_t>( std::chrono::system_clock::now().time_since_epoch().count() ), extra_seed ), 
+												 extra_seed }
+{}
+
+RandomNumberGenerator::RandomNumberGenerator( const uint64_t seed, const uint64_t stream ) :
+	key_{ static_cast<uint32_t>( seed & 0xFFFFFFFF ), static_cast<uint32_t>( seed >> 32 ) },
+	stream_( stream ),
+	counter_( 0 ),
+	block_{ 0, 0, 0, 0 },
+	block_index_( 4 ),
+	quasi_random_( false ),
+	scramble_key_( 0 ),
+	sequence_index_( 0 )
+{}
+
+uint64_t RandomNumberGenerator::CombineIdentifiers( const uint64_t first, const uint64_t second ){
+
+	// splitmix64 finalizer applied to both identifiers
+	uint64_t mixed = first + 0x9E3779B97F4A7C15ull * ( second + 1 );
+	mixed = ( mixed ^ ( mixed >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+	mixed = ( mixed ^ ( mixed >> 27 ) ) * 0x94D049BB133111EBull;
+	return mixed ^ ( mixed >> 31 );
+}
+
+void RandomNumberGenerator::GenerateBlock( void ){
+
+	// algorithm from Salmon et al. "Parallel random numbers: as easy as 1, 2, 3"
+	constexpr uint32_t multiplier_0 = 0xD2511F53;
+	constexpr uint32_t multiplier_1 = 0xCD9E8D57;
+	constexpr uint32_t key_increment_0 = 0x9E3779B9;
+	constexpr uint32_t key_increment_1 = 0xBB67AE85;
+
+	uint32_t counter[4] = { static_cast<uint32_t>( counter_ & 0xFFFFFFFF ), static_cast<uint32_t>( counter_ >> 32 ),
+													static_cast<uint32_t>( stream_ & 0xFFFFFFFF ), static_cast<uint32_t>( stream_ >> 32 ) };
+	uint32_t key[2] = { key_[0], key_[1] };
+
+	for( size_t round = 0; round < 10; round++ ){
+
+		const uint64_t product_0 = static_cast<uint64_t>( multiplier_0 ) * counter[0];
+		const uint64_t product_1 = static_cast<uint64_t>( multiplier_1 ) * counter[2];
+
+		const uint32_t new_counter[4] = { static_cast<uint32_t>( product_1 >> 32 ) ^ counter[1] ^ key[0],
+																			static_cast<uint32_t>( product_1 ),
+																			static_cast<uint32_t>( product_0 >> 32 ) ^ counter[3] ^ key[1],
+																			static_cast<uint32_t>( product_0 ) };
+
+		for( size_t word = 0; word < 4; word++ ) counter[word] = new_counter[word];
+
+		key[0] += key_increment_0;
+		key[1] += key_increment_1;
+	}
+
+	for( size_t word = 0; word < 4; word++ ) block_[word] = counter[word];
 	
-	generator_state_{ static_cast<uint64_t>( std::chrono::system_clock::now().time_since_epoch().count() + extra_seed ) |
-										( static_cast<uint64_t>( std::chrono::system_clock::now().time_since_epoch().count() + extra_seed ) << 32 ),
-										static_cast<uint64_t>( std::chrono::system_clock::now().time_since_epoch().count() + extra_seed ) |
-										( static_cast<uint64_t>( std::chrono::system_clock::now().time_since_epoch().count() + extra_seed ) << 32 ) }//,
+	counter_++;
+	block_index_ = 0;
+}
 
-{
+void RandomNumberGenerator::EnableQuasiRandom( const uint64_t scramble_key, const uint64_t sequence_index ){
+	quasi_random_ = true;
+	scramble_key_ = scramble_key;
+	sequence_index_ = sequence_index;
+}
 
+double RandomNumberGenerator::GetScrambledRadicalInverse( const size_t dimension ) const{
+
+	const uint32_t base = halton_bases[dimension];
+	const double inverse_base = 1. / static_cast<double>( base );
+	const uint64_t dimension_key = CombineIdentifiers( scramble_key_, dimension );
+
+	uint64_t remaining_index = sequence_index_;
+	double digit_factor = inverse_base;
+	double radical_inverse = 0.;
+
+	// every digit is permuted by a random affine map. digits beyond the index are permuted zeros.
+	// A shift alone keeps few points of a large base in one block of neighbouring intervals
+	for( size_t digit_index = 0; digit_factor > 1e-10; digit_index++ ){
+		
+		const uint64_t digit = remaining_index % base;
+		remaining_index /= base;
+
+		const uint64_t digit_key = CombineIdentifiers( dimension_key, digit_index );
+		const uint64_t factor = 1 + ( digit_key >> 32 ) % ( base - 1 );	// invertible because the base is prime
+		const uint64_t shift = ( digit_key & 0xFFFFFFFF ) % base;
+		radical_inverse += static_cast<double>( ( factor * digit + shift ) % base ) * digit_factor;
+
+		digit_factor *= inverse_base;
+	}
+
+	return ForceToMax( radical_inverse, 1. - 1e-12 );
 }
 
 unsigned int RandomNumberGenerator::GetRandomNumber( void ){
 
-	// algorithm from https://prng.di.unimi.it/xoroshiro128starstar.c
-	const unsigned long long int s0 = generator_state_[0];
-	unsigned long long int s1 = generator_state_[1];
-	const unsigned long long int result = std::rotl(s0 * 5, 7) * 9;
-	s1 ^= s0;
+	if( block_index_ >= 4 ) GenerateBlock();
 
-	const unsigned long long int new_state_0 = std::rotl(s0, 24) ^ s1 ^ (s1 << 16);
-	const unsigned long long int new_state_1 = std::rotl(s1, 37);
-	
-	generator_state_[0] = new_state_0;
-	generator_state_[1] = new_state_1;
-
-	return static_cast<unsigned int>( result & 0x00000000FFFFFFFF );
+	return static_cast<unsigned int>( block_[block_index_++] );
 }
 
 unsigned short int RandomNumberGenerator::GetRandomShortNumber(void) {
 	return static_cast<unsigned short int>( ( GetRandomNumber() & 0xFFFF0000 ) >> 16 );
 }
 
+double RandomNumberGenerator::GetUniformNumber( void ){
+	return static_cast<double>( GetRandomNumber() ) / ( static_cast<double>( UINT32_MAX ) + 1. );
+}
+
+double RandomNumberGenerator::GetUniformNumber( const size_t dimension ){
+
+	if( quasi_random_ && dimension < number_of_quasi_random_dimensions ) 
+		return GetScrambledRadicalInverse( dimension );
+
+	return GetUniformNumber();
+}
+
 bool RandomNumberGenerator::DidARandomEventHappen( const double event_propability ){
 
 	const unsigned int interval = UINT32_MAX;
@@ -81,40 +167,129 @@ bool RandomNumberGenerator::DidARandomEventHappen( const double event_propabilit
 	propabilityDistribution implementation
 */
 
-PropabilityDistribution::PropabilityDistribution( vector<Tuple2D> distribution ) :	
-	values_( distribution.size(), 0. )
+PropabilityDistribution::PropabilityDistribution( vector<Tuple2D> distribution, const bool interpolate ) :	
+	values_( 0 ),
+	alias_propabilities_( 0 ),
+	aliases_( 0 ),
+	interpolate_( interpolate )
 {
-	std::sort(distribution.begin(), distribution.end(), [](Tuple2D a, Tuple2D b) { return a.y < b.y; });
+	if( distribution.empty() ) distribution.emplace_back( 0., 1. );
+
+	// sort by value for interpolation between neighbours
+	std::sort( distribution.begin(), distribution.end(), []( const Tuple2D& a, const Tuple2D& b ) { return a.x < b.x; } );
+
+	const size_t number_of_values = distribution.size();
 
 	double weight_sum = 0.;
-	for (const auto& [value, weight] : distribution) {
-		weight_sum += weight;
+	for( const auto& [ value, weight ] : distribution ){
+		values_.push_back( value );
+		weight_sum += ForcePositive( weight );
 	}
 
-	const double weight_per_bin = weight_sum / static_cast<double>( number_of_elements );
+	// propabilities scaled so that their mean is one
+	vector<double> scaled_propabilities( number_of_values, 1. );
+	if( weight_sum > 0. ){
+		for( size_t index = 0; index < number_of_values; index++ )
+			scaled_propabilities.at( index ) = ForcePositive( distribution.at( index ).y ) / weight_sum * static_cast<double>( number_of_values );
+	}
 
-	unsigned int current_index = 0;
-	for (const auto& [value, weight] : distribution) {
+	alias_propabilities_ = vector<double>( number_of_values, 1. );
+	aliases_ = vector<size_t>( number_of_values, 0 );
 
-		values_.at(current_index) = value;
+	// work lists with bins below and above the mean propability
+	vector<size_t> small_bins, large_bins;
+	for( size_t index = 0; index < number_of_values; index++ ){
+		aliases_.at( index ) = index;
+		if( scaled_propabilities.at( index ) < 1. ) small_bins.push_back( index );
+		else large_bins.push_back( index );
+	}
 
-		const unsigned int current_number_of_elements = static_cast<unsigned int>( round( weight / weight_per_bin) );
+	// fill each small bin with the surplus of a large bin
+	while( !small_bins.empty() && !large_bins.empty() ){
+		
+		const size_t small_index = small_bins.back(); small_bins.pop_back();
+		const size_t large_index = large_bins.back(); large_bins.pop_back();
 
-		discrete_distribution_.insert(discrete_distribution_.end(), current_number_of_elements, current_index++ );
-	
+		alias_propabilities_.at( small_index ) = scaled_propabilities.at( small_index );
+		aliases_.at( small_index ) = large_index;
+
+		scaled_propabilities.at( large_index ) = 
+			( scaled_propabilities.at( large_index ) + scaled_propabilities.at( small_index ) ) - 1.;
+
+		if( scaled_propabilities.at( large_index ) < 1. ) small_bins.push_back( large_index );
+		else large_bins.push_back( large_index );
+	}
+
+	// remaining bins are full up to numerical errors
+	for( const size_t index : small_bins ) alias_propabilities_.at( index ) = 1.;
+	for( const size_t index : large_bins ) alias_propabilities_.at( index ) = 1.;
+
+}
+
+PropabilityDistribution::PropabilityDistribution( const vector<char>& binary_data, vector<char>::const_iterator& current_byte ) :
+	values_( DeSerializeBuildIn<size_t>( 0, binary_data, current_byte ), 0. ),
+	alias_propabilities_( values_.size(), 1. ),
+	aliases_( values_.size(), 0 ),
+	interpolate_( DeSerializeBuildIn<bool>( false, binary_data, current_byte ) )
+{
+	for( size_t index = 0; index < values_.size(); index++ ){
+		values_.at( index ) = DeSerializeBuildIn<double>( 0., binary_data, current_byte );
+		alias_propabilities_.at( index ) = DeSerializeBuildIn<double>( 1., binary_data, current_byte );
+		aliases_.at( index ) = ForceToMax( DeSerializeBuildIn<size_t>( index, binary_data, current_byte ), values_.size() - 1 );
 	}
 
-	if( number_of_elements > discrete_distribution_.size() )
-		discrete_distribution_.insert(discrete_distribution_.end(), number_of_elements - discrete_distribution_.size(), current_index - 1);
+	if( values_.empty() ){
+		values_.push_back( 0. );
+		alias_propabilities_.push_back( 1. );
+		aliases_.push_back( 0 );
+	}
+}
+
+size_t PropabilityDistribution::Serialize( vector<char>& binary_data ) const{
+
+	size_t number_of_bytes = 0;
+	number_of_bytes += SerializeBuildIn<size_t>( values_.size(), binary_data );
+	number_of_bytes += SerializeBuildIn<bool>( interpolate_, binary_data );
+
+	for( size_t index = 0; index < values_.size(); index++ ){
+		number_of_bytes += SerializeBuildIn<double>( values_.at( index ), binary_data );
+		number_of_bytes += SerializeBuildIn<double>( alias_propabilities_.at( index ), binary_data );
+		number_of_bytes += SerializeBuildIn<size_t>( aliases_.at( index ), binary_data );
+	}
+
+	return number_of_bytes;
+}
 
+double PropabilityDistribution::GetRandomNumber( RandomNumberGenerator& generator ) const{
+	return GetValue( generator.GetUniformNumber() );
 }
 
-double PropabilityDistribution::GetRandomNumber( RandomNumberGenerator& generator ) const{//mutex& distribution_mutex ){
+double PropabilityDistribution::GetValue( const double uniform_number ) const{
+
+	// one uniform number selects the bin and decides between bin and alias
+	const double scaled_uniform = uniform_number * static_cast<double>( values_.size() );
+	const size_t bin_index = ForceToMax( static_cast<size_t>( scaled_uniform ), values_.size() - 1 );
+	double remainder = scaled_uniform - static_cast<double>( bin_index );
+
+	const double alias_propability = alias_propabilities_[bin_index];
+	size_t index = bin_index;
+
+	if( remainder < alias_propability ){
+		remainder /= alias_propability;
+	}
+	else{
+		index = aliases_[bin_index];
+		remainder = ( remainder - alias_propability ) / ( 1. - alias_propability );
+	}
+
+	if( !interpolate_ ) return values_[index];
 
-	unsigned short int random_number = generator.GetRandomShortNumber();
-	unsigned int index = discrete_distribution_.at(random_number);
-	const double value = values_.at(index);
+	// the remainder is again uniform in [0, 1) and places the value between the midpoints to its neighbours
+	const double lower_edge = index > 0 ? 
+															( values_[index - 1] + values_[index] ) / 2. : values_[index];
+	const double upper_edge = index < values_.size() - 1 ? 
+															( values_[index] + values_[index + 1] ) / 2. : values_[index];
 
-	return value;
+	return lower_edge + remainder * ( upper_edge - lower_edge );
 
 }
\ No newline at end of file
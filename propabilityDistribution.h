@@ -24,6 +24,8 @@
 
 /*!
  * @brief class for a generic random number generator with a uniform distribution between 0 and 2^32 - 1
+ * @details counter based generator (Philox4x32-10). The numbers only depend on the key and the stream. 
+ * Generators with the same key and stream produce identical sequences independent of thread or order of creation
 */
 class RandomNumberGenerator{
 
@@ -31,9 +33,35 @@ class RandomNumberGenerator{
 	
 	/*!
 	 * @brief constructor
+	 * @details key is taken from the system clock. Sequences are not reproducible
+	 * @param extra_seed value added to the key and used as stream
 	*/
 	RandomNumberGenerator( const unsigned long long int extra_seed = 0 );
 
+	/*!
+	 * @brief constructor for reproducible sequences
+	 * @param seed key of generator
+	 * @param stream identifier of the sequence with given key
+	*/
+	RandomNumberGenerator( const uint64_t seed, const uint64_t stream );
+
+	/*!
+	 * @brief combine two identifiers into one well mixed identifier
+	 * @param first first identifier
+	 * @param second second identifier
+	 * @return combined identifier
+	*/
+	static uint64_t CombineIdentifiers( const uint64_t first, const uint64_t second );
+
+	/*!
+	 * @brief switch to quasi random numbers
+	 * @details numbers for sampling decisions with fixed dimension are the coordinates of a point of a scrambled halton sequence. 
+	 * Numbers without dimension and dimensions beyond the sequence's are pseudo random
+	 * @param scramble_key key for the digit scrambling. points with the same key belong to the same sequence
+	 * @param sequence_index index of the point in the sequence
+	*/
+	void EnableQuasiRandom( const uint64_t scramble_key, const uint64_t sequence_index );
+
 	/*!
 	 * @brief get a random number
 	 * @return a random integer
@@ -46,6 +74,21 @@ class RandomNumberGenerator{
 	*/
 	unsigned short int GetRandomShortNumber(void);
 
+	/*!
+	 * @brief get a random number uniformly distributed in [0, 1)
+	 * @return random number
+	*/
+	double GetUniformNumber( void );
+
+	/*!
+	 * @brief get a number uniformly distributed in [0, 1) for a sampling decision with fixed dimension
+	 * @details the coordinate of the quasi random point in this dimension when quasi random numbers are enabled. 
+	 * Every decision must use its own dimension
+	 * @param dimension dimension of the decision
+	 * @return random number
+	*/
+	double GetUniformNumber( const size_t dimension );
+
 	/*!
 	 * @brief check if an event with given propability "happened"
 	 * @param event_propability event propabilitx 
@@ -56,13 +99,39 @@ class RandomNumberGenerator{
 
 	private:
 
-	unsigned long long int generator_state_[2];		/*!< current generator state*/
+	uint32_t key_[2];							/*!< key of generator*/
+	uint64_t stream_;							/*!< stream identifier. upper half of the counter*/
+	uint64_t counter_;						/*!< counter of generated blocks. lower half of the counter*/
+	uint32_t block_[4];						/*!< current block of random numbers*/
+	size_t block_index_;					/*!< index of next number in block*/
+
+	bool quasi_random_;						/*!< flag for quasi random numbers*/
+	uint64_t scramble_key_;				/*!< key for scrambling of the quasi random digits*/
+	uint64_t sequence_index_;			/*!< index of the quasi random point*/
+
+	static constexpr size_t number_of_quasi_random_dimensions = 32;	/*!< amount of dimensions with quasi random numbers*/
+	static constexpr uint32_t halton_bases[number_of_quasi_random_dimensions] = {	2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 
+																																								59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131 };	/*!< prime bases of the halton sequence*/
+
+
+	/*!
+	 * @brief generate the next block of random numbers
+	*/
+	void GenerateBlock( void );
+
+	/*!
+	 * @brief get the radical inverse of the sequence index with scrambled digits
+	 * @param dimension dimension of the point
+	 * @return number in [0, 1)
+	*/
+	double GetScrambledRadicalInverse( const size_t dimension ) const;
 
 };
 
 
 /*!
  * @brief class to store a custom propability distribution
+ * @details values are sampled with Vose's alias method in constant time
 */
 class PropabilityDistribution{
 
@@ -71,20 +140,42 @@ class PropabilityDistribution{
 	/*!
 	 * @brief constructor
 	 * @param distribution Pseudo distribution. sum of y values must not be equal to one
+	 * @param interpolate when true the sampled value is distributed uniformly between the midpoints to its neighbouring values
 	*/
-	PropabilityDistribution( vector<Tuple2D> distribution );
+	PropabilityDistribution( vector<Tuple2D> distribution, const bool interpolate = false );
+
+	/*!
+	 * @brief constructor from serialized data
+	 * @param binary_data reference to vector with binary data
+	 * @param current_byte iterator to start of data in vector
+	*/
+	PropabilityDistribution( const vector<char>& binary_data, vector<char>::const_iterator& current_byte );
+
+	/*!
+	 * @brief serialize this object
+	 * @param binary_data reference to vector where data will be appended
+	 * @return written bytes
+	*/
+	size_t Serialize( vector<char>& binary_data ) const;
 
 	/*!
 	 * @brief get a random value according to distribution
 	*/
 	double GetRandomNumber( RandomNumberGenerator& generator ) const; 
 
+	/*!
+	 * @brief get the value of the distribution for a uniform number
+	 * @param uniform_number number in [0, 1)
+	 * @return value
+	*/
+	double GetValue( const double uniform_number ) const;
+
 
 	private:
-	
-	static constexpr unsigned int number_of_elements = USHRT_MAX + 1;	/*!< number of bins*/
 
-	vector<double> values_;												/*!< values of distribution*/
-	vector<unsigned int> discrete_distribution_;	/*!< vector filled with indices for the values_ vector according to their propability*/
+	vector<double> values_;									/*!< values of distribution sorted ascending*/
+	vector<double> alias_propabilities_;		/*!< propability to keep the sampled bin instead of its alias*/
+	vector<size_t> aliases_;								/*!< index of each bin's alias*/
+	bool interpolate_;											/*!< flag for interpolation between neighbouring values*/
 
 };
\ No newline at end of file
@@ -32,6 +32,13 @@ class RadonCoordinates{
 	*/
 	RadonCoordinates( const CoordinateSystem* const radon_coordinate_system, const Line line );
 
+	/*!
+	 * @brief constructor
+	 * @param theta angle
+	 * @param distance distance
+	*/
+	RadonCoordinates( const double theta, const double distance ) : theta( theta ), distance( distance ){};
+
 
 	double theta;			/*!< angle*/
 	double distance;	/*!< distance*/
@@ -122,6 +122,7 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 													const double distance_traveled_mm, 
 													const TomographyProperties& tomography_properties, 
 													const Point3D& new_origin,
+													ScatteringSearch& search,
 													RandomNumberGenerator& dedicated_rng ){
 
 	// voxel's absorption with respect to water's absorption
@@ -147,6 +148,13 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 	vector<Ray> scattered_rays;
 	// skip if scattering is extremely inpropable
 	if( IsNearlyEqual( coefficient_factor, 0., 1e-6, Relative ) ) return scattered_rays;
+
+	// forced detection: expected scattering instead of random events
+	if( tomography_properties.forced_detection ){
+		scattered_rays.push_back( GetScatteringSource( coefficient_factor, distance_traveled_mm, 
+																									 tomography_properties, new_origin ) );
+		return scattered_rays;
+	}
 	
 
 	vector<pair<double, pair<double, double>>> scattered_angles;
@@ -154,10 +162,54 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 	// number of scatteres bins over all energies
 	size_t scattered_bins_sum = 0;
 
-	// iterate energies in spectrum
+	// the bins of all energies are independent bernoulli trials. Candidates for scattering are searched with the 
+	// propability of the largest cross section and accepted with the propability of the bin's energy. 
+	// The amount of bins until the next candidate is drawn from a geometric distribution.
+	// The uniform number carries over to the next voxel after rescaling when no candidate is left in this voxel
+	const double max_scatter_propability = ForceToMax( 
+		( 1. - exp( -ScatteringCrossSection::GetInstance().max_cross_section() * electron_density_water_1Permm3 * 
+								coefficient_factor * distance_traveled_mm ) ) * tomography_properties.scatter_propability_correction, 1. );
+	
+	if( max_scatter_propability <= 0. ) return scattered_rays;
+
+	const vector<Tuple2D> spectrum_data = properties_.energy_spectrum_.data();
+	const size_t number_of_bins = simulation_properties.bins_per_energy * spectrum_data.size();
+
+	if( search.uniform_number <= 0. ) 
+		search.uniform_number = 1. - dedicated_rng.GetUniformNumber( search.GetDimension( ScatteringSearch::Decision::Search ) );
+
 	size_t energy_index = 0;
-	for( const auto& [ energy, photons ] : properties_.energy_spectrum_.data() ){
+	size_t bin_index = 0;		// index of bin over all energies
+
+	while( true ){
+
+		// bins left in this voxel
+		const size_t remaining_bins = number_of_bins - bin_index;
+
+		// amount of bins without candidate before the next candidate
+		const double skipped_bins = max_scatter_propability >= 1. ? 0. :
+																	floor( log( search.uniform_number ) / log1p( -max_scatter_propability ) );
+
+		// no more candidate in this voxel -> rescale uniform number for next voxel
+		if( skipped_bins >= static_cast<double>( remaining_bins ) ){
+			search.uniform_number = ForceToMax( search.uniform_number / 
+				pow( 1. - max_scatter_propability, static_cast<double>( remaining_bins ) ), 1. );
+			break;
+		}
+
+		// candidate found. next search starts after it with a new uniform number
+		bin_index += static_cast<size_t>( skipped_bins );
+		energy_index = bin_index / simulation_properties.bins_per_energy;
+		bin_index++;
+
+		const double acceptance_number = dedicated_rng.GetUniformNumber( search.GetDimension( ScatteringSearch::Decision::Acceptance ) );
+		const double angle_number = dedicated_rng.GetUniformNumber( search.GetDimension( ScatteringSearch::Decision::Angle ) );
+		search.number_of_candidates++;
+		search.uniform_number = 1. - dedicated_rng.GetUniformNumber( search.GetDimension( ScatteringSearch::Decision::Search ) );
 		
+		const double energy = spectrum_data.at( energy_index ).x;
+		const double photons = spectrum_data.at( energy_index ).y;
+
 		// no photons at current energy
 		if( IsNearlyEqual( photons, 0., 1e-6, Relative ) ) continue;
 
@@ -169,59 +221,46 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 																			electron_density_water_1Permm3 * 
 																			coefficient_factor;
 
-		const double scatter_propability =  1. - exp( -coefficient_1Permm * 
-																								  distance_traveled_mm );
+		const double scatter_propability = ForceToMax( ( 1. - exp( -coefficient_1Permm * distance_traveled_mm ) ) * 
+																									 tomography_properties.scatter_propability_correction, 1. );
 
-		// iterate through energy bins
-		for( size_t bin = 0; bin < simulation_properties.bins_per_energy; bin++ ){
-
-			// does scattering happen?
-			if( !dedicated_rng.DidARandomEventHappen( 
-					scatter_propability * tomography_properties.scatter_propability_correction ) )
-				continue;
-			
-			// check if angle is scattered inside scattering plane
-			if( std::abs( scattering_information.GetRandomAngle( 
-																energy, dedicated_rng ) ) <=
-																scattering_information.max_angle_to_lie_in_plane() ){
+		// candidate is rejected with the bin's propability
+		if( acceptance_number * max_scatter_propability >= scatter_propability ) continue;
 			
-				// random angle inside scattering plane
-				const double angle = ForceRange( scattering_information.GetRandomAngle( 
-																				 energy, dedicated_rng ), -PI, PI );
+		// random angle inside scattering plane
+		const double angle = ForceRange( scattering_information.GetAngle( energy, angle_number ), -PI, PI );
 				
-				// if angle is almost zero -> treat as if no scattering happened
-				if( IsNearlyEqual( angle, 0., 1e-3, Relative ) ) continue;
-
-				// calculate scattered photons energy via compton-wavelength
-				const double new_energy = 
-					1. / ( 1. / ( me_c2_eV ) * ( 1. - cos( angle ) )  + 1. / energy );
-					
-				// new photonflow
-				const double new_photonflow = 
-					tomography_properties.scattered_ray_absorption_factor * photons / 
-					static_cast<double>( simulation_properties.bins_per_energy );
-
-				scattered_angles.emplace_back( angle, 
-																			 pair<double, double>{ new_energy, new_photonflow });
-			}
-
-			// scalar for energy in incoming ray. only accounts for energy lost to new rays
-			// without considering der angle dependent energy loss (Compton-Aporption). 
-			// this is because the compton-absorption is already accounted for in the absorption 
-			// routine
-			const double energy_scalar = 
-				1. - tomography_properties.scattered_ray_absorption_factor / 
-				static_cast<double>( simulation_properties.bins_per_energy );
-
-			properties_.energy_spectrum_.ScaleEnergy( energy_index, energy_scalar );
-			#ifdef TRANSMISSION_TRACKING
-			properties_.only_scattering_spectrum.ScaleEnergy( energy_index, energy_scalar );
-			#endif
-			
-			scattered_bins_sum++;
-		}
+		// if angle is almost zero -> treat as if no scattering happened
+		if( IsNearlyEqual( angle, 0., 1e-3, Relative ) ) continue;
 
-		energy_index++;
+		// calculate scattered photons energy via compton-wavelength
+		const double new_energy = 
+			1. / ( 1. / ( me_c2_eV ) * ( 1. - cos( angle ) )  + 1. / energy );
+				
+		// new photonflow. instead of discarding photons not scattered into the scattering plane
+		// every scattered ray carries the propability to lie in the plane
+		const double new_photonflow = 
+			tomography_properties.scattered_ray_absorption_factor * photons / 
+			static_cast<double>( simulation_properties.bins_per_energy ) *
+			scattering_information.GetPropabilityToLieInPlane( energy );
+
+		scattered_angles.emplace_back( angle, 
+																		pair<double, double>{ new_energy, new_photonflow });
+
+		// scalar for energy in incoming ray. only accounts for energy lost to new rays
+		// without considering der angle dependent energy loss (Compton-Aporption). 
+		// this is because the compton-absorption is already accounted for in the absorption 
+		// routine
+		const double energy_scalar = 
+			1. - tomography_properties.scattered_ray_absorption_factor / 
+			static_cast<double>( simulation_properties.bins_per_energy );
+
+		properties_.energy_spectrum_.ScaleEnergy( energy_index, energy_scalar );
+		#ifdef TRANSMISSION_TRACKING
+		properties_.only_scattering_spectrum.ScaleEnergy( energy_index, energy_scalar );
+		#endif
+		
+		scattered_bins_sum++;
 	}
 
 	// no ray scattered in scattering plane -> return empty
@@ -291,7 +330,8 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 			// simple intensity
 			const double scattered_bins_fraction = 
 					static_cast<double>( scattered_bins_for_current_angle ) / 
-					static_cast<double>( scattered_bins_sum );
+					static_cast<double>( scattered_bins_sum ) *
+					scattering_information.GetPropabilityToLieInPlane( reference_energy_for_mu_eV );
 
 			const EnergySpectrum new_spectrum{ spectral_photonflows }; 
 
@@ -302,6 +342,10 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 																				 scattered_bins_fraction * 
 																				 simple_fraction;
 			new_properties.initial_power_ = new_spectrum.GetTotalPower();
+			new_properties.scattering_occurrences_ = properties_.scattering_occurrences_ + 1;
+			new_properties.identifier_ = RandomNumberGenerator::CombineIdentifiers( 
+				RandomNumberGenerator::CombineIdentifiers( properties_.identifier_, properties_.voxel_hits_ ), 
+				scattered_rays.size() );
 
 			const Unitvector3D new_direction = 
 				direction_.RotateConstant( scattering_information.scattering_plane_normal(),
@@ -324,6 +368,109 @@ vector<Ray> Ray::Scatter( const RayScattering& scattering_information,
 }
 
 
+Ray Ray::GetScatteringSource( const double coefficient_factor, 
+															 const double distance_traveled_mm, 
+															 const TomographyProperties& tomography_properties, 
+															 const Point3D& new_origin ){
+
+	const double bins_per_energy = static_cast<double>( simulation_properties.bins_per_energy );
+	
+	// photonflows of all photons which will be scattered
+	vector<Tuple2D> scattered_photonflows;
+
+	size_t energy_index = 0;
+	for( const auto& [ energy, photons ] : properties_.energy_spectrum_.data() ){
+
+		const double coefficient_1Permm = 
+			ScatteringCrossSection::GetInstance().GetCrossSection( energy ) * 
+			electron_density_water_1Permm3 * coefficient_factor;
+
+		// propability of a scattering event in each bin
+		const double event_propability = ForceToMax( 
+			( 1. - exp( -coefficient_1Permm * distance_traveled_mm ) ) * 
+			tomography_properties.scatter_propability_correction, 1. );
+
+		// expected photonflow in scattered rays 
+		scattered_photonflows.emplace_back( energy, photons * event_propability * 
+																								tomography_properties.scattered_ray_absorption_factor );
+
+		// each event scales the energy by the same factor as in random scattering.
+		// this is the expected value of that factor over a binomial distributed amount of events
+		const double energy_scalar = pow( 1. - event_propability * 
+																			tomography_properties.scattered_ray_absorption_factor / 
+																			bins_per_energy, bins_per_energy );
+
+		properties_.energy_spectrum_.ScaleEnergy( energy_index, energy_scalar );
+		#ifdef TRANSMISSION_TRACKING
+		properties_.only_scattering_spectrum.ScaleEnergy( energy_index, energy_scalar );
+		#endif
+
+		energy_index++;
+	}
+
+	// simple intensity of scattered photons at reference energy
+	const double reference_event_propability = ForceToMax( 
+		( 1. - exp( -ScatteringCrossSection::GetInstance().GetCrossSection( reference_energy_for_mu_eV ) * 
+								 electron_density_water_1Permm3 * coefficient_factor * distance_traveled_mm ) ) * 
+		tomography_properties.scatter_propability_correction, 1. );
+
+	RayProperties source_properties{ EnergySpectrum{ scattered_photonflows } };
+	source_properties.voxel_hits_ = properties_.voxel_hits_;
+	source_properties.scattering_occurrences_ = properties_.scattering_occurrences_ + 1;
+	source_properties.identifier_ = RandomNumberGenerator::CombineIdentifiers( properties_.identifier_, properties_.voxel_hits_ );
+	source_properties.simple_intensity_ = properties_.simple_intensity_ * reference_event_propability * 
+																				tomography_properties.scattered_ray_absorption_factor;
+
+	return Ray{ direction_, new_origin, source_properties };
+}
+
+
+optional<Ray> Ray::GetForcedScatteredRay( const RayScattering& scattering_information, 
+																					const Unitvector3D& new_direction, 
+																					const double covered_angle, 
+																					const size_t pixel_index ) const{
+
+	// signed scattering angle. positive angles rotate counter clockwise around the plane normal
+	double angle = direction_.GetAngle( new_direction );
+	if( ( direction_ ^ new_direction ) * scattering_information.scattering_plane_normal() < 0. )
+		angle = -angle;
+
+	// unscattered photons are not part of the scattering source
+	if( IsNearlyEqual( angle, 0., 1e-3, Absolute ) ) return {};
+
+	// fraction of angle bins covered by target
+	const double covered_bins = covered_angle / scattering_information.angle_resolution();
+
+	vector<Tuple2D> photonflows;
+
+	for( const auto& [ energy, photons ] : properties_.energy_spectrum_.data() ){
+		
+		// propability to scatter into the target
+		const double propability = scattering_information.GetPropabilityToLieInPlane( energy ) * 
+															 scattering_information.GetAnglePropability( energy, angle ) * 
+															 covered_bins;
+
+		// scattered photons energy via compton-wavelength
+		const double new_energy = 1. / ( 1. / ( me_c2_eV ) * ( 1. - cos( angle ) ) + 1. / energy );
+
+		photonflows.emplace_back( new_energy, photons * propability );
+	}
+
+	const double reference_propability = 
+		scattering_information.GetPropabilityToLieInPlane( reference_energy_for_mu_eV ) * 
+		scattering_information.GetAnglePropability( reference_energy_for_mu_eV, angle ) * 
+		covered_bins;
+
+	RayProperties new_properties{ EnergySpectrum{ photonflows }, pixel_index, true };
+	new_properties.voxel_hits_ = properties_.voxel_hits_;
+	new_properties.simple_intensity_ = properties_.simple_intensity_ * reference_propability;
+	new_properties.identifier_ = RandomNumberGenerator::CombineIdentifiers( properties_.identifier_, pixel_index );
+	new_properties.scattering_occurrences_ = properties_.scattering_occurrences_;
+
+	return Ray{ new_direction, origin_, new_properties };
+}
+
+
 void Ray::SetExpectedPixelIndex( const size_t pixel_index, const bool definitely_hits ){
 	properties_.expected_detector_pixel_index_ = pixel_index;
 	properties_.definitely_hits_expected_pixel_ = definitely_hits;
@@ -13,6 +13,9 @@
 	Includes
 *********************************************************************/
 
+#include <optional>
+using std::optional;
+
 #include "line.h"
 #include "voxel.h"
 #include "energySpectrum.h"
@@ -67,7 +70,7 @@ class RayProperties{
 	*/
 	RayProperties( const EnergySpectrum spectrum, const size_t expected_pixel_index = 0, const bool definitely_hits_expected_pixel = false ) :
 		energy_spectrum_( spectrum ), voxel_hits_( 0 ), initial_power_( energy_spectrum_.GetTotalPower() ), expected_detector_pixel_index_( expected_pixel_index ),
-		simple_intensity_( 1. ), definitely_hits_expected_pixel_( definitely_hits_expected_pixel )
+		simple_intensity_( 1. ), definitely_hits_expected_pixel_( definitely_hits_expected_pixel ), identifier_( 0 ), scattering_occurrences_( 0 )
 		#ifdef TRANSMISSION_TRACKING
 		,only_scattering_spectrum( energy_spectrum_ )
 		,only_absorption_spectrum( energy_spectrum_ )
@@ -79,7 +82,7 @@ class RayProperties{
 	*/
 	RayProperties( void ) :
 		energy_spectrum_( EnergySpectrum{} ), voxel_hits_( 0 ), initial_power_( energy_spectrum_.GetTotalPower() ), expected_detector_pixel_index_( 0 ), simple_intensity_( 1. ),
-		definitely_hits_expected_pixel_( false )
+		definitely_hits_expected_pixel_( false ), identifier_( 0 ), scattering_occurrences_( 0 )
 		#ifdef TRANSMISSION_TRACKING
 		,only_scattering_spectrum( energy_spectrum_ )
 		,only_absorption_spectrum( energy_spectrum_ )
@@ -116,6 +119,18 @@ class RayProperties{
 	*/
 	double simple_intensity( void ) const{ return simple_intensity_; };
 
+	/*!
+	 * @brief get the ray's identifier
+	 * @return identifier which selects the ray's random number stream
+	*/
+	uint64_t identifier( void ) const{ return identifier_; };
+
+	/*!
+	 * @brief get how often the ray's photons were scattered
+	 * @return amount of scatterings. Zero for primary rays
+	*/
+	size_t scattering_occurrences( void ) const{ return scattering_occurrences_; };
+
 	/*!
 	 * @brief scale specturm linearly
 	 * @param factor factor to scale by
@@ -138,6 +153,8 @@ class RayProperties{
 	size_t expected_detector_pixel_index_;	/*!< index of detector pixel the ray is likely to hit*/
 	double simple_intensity_;								/*!< current "simple" intensity. According to lambert beer's equation J = J * exp( -l * mu ) */
 	bool definitely_hits_expected_pixel_;		/*!< flag to indicate that this ray definitely hits the expected ray*/
+	uint64_t identifier_;										/*!< identifier of ray. derived from the parent's identifier for scattered rays*/
+	size_t scattering_occurrences_;					/*!< amount of scatterings of the ray's photons*/
 
 	#ifdef TRANSMISSION_TRACKING
 	public:
@@ -149,6 +166,39 @@ class RayProperties{
 };
 
 
+/*!
+ * @brief class for the state of the search for scattering along a ray's path through a model
+ * @details one uniform number selects the bin of the next scattering candidate and carries over from voxel to voxel.
+ * Each decision of a candidate has a fixed dimension for quasi random numbers
+*/
+class ScatteringSearch{
+
+	public:
+
+	/*!
+	 * @brief sampling decisions of a candidate
+	*/
+	enum class Decision{
+		Search,				/*!< search for the candidate's bin*/
+		Acceptance,		/*!< acceptance with the bin's propability*/
+		Angle,				/*!< scattering angle*/
+		End
+	};
+
+	double uniform_number = 0.;					/*!< uniform number of the current search. A new number is drawn when not positive*/
+	size_t number_of_candidates = 0;		/*!< amount of candidates found on the path*/
+
+	/*!
+	 * @brief get the quasi random dimension of a decision for the current candidate
+	 * @param decision sampling decision
+	 * @return dimension
+	*/
+	size_t GetDimension( const Decision decision ) const{ 
+		return number_of_candidates * ConvertToUnderlying( Decision::End ) + ConvertToUnderlying( decision ); };
+
+};
+
+
 /*!
  * @brief class for rays
 */
@@ -199,6 +249,12 @@ class Ray : public Line{
 		properties_.simple_intensity_ *= factor;
 	};
 
+	/*!
+	 * @brief set the identifier of this ray
+	 * @param identifier new identifier
+	*/
+	void SetIdentifier( const uint64_t identifier ){ properties_.identifier_ = identifier; };
+
 	/*!
 	 * @brief increment the voxel hit count
 	*/
@@ -270,11 +326,25 @@ class Ray : public Line{
 	 * @param distance_traveled_mm distance traveled in voxel
 	 * @param tomography_properties properties of tomogrpahy
 	 * @param new_origin point where scattering occured
+	 * @param search state of the search for scattering along the ray's path. Carries over from voxel to voxel
 	 * @param dedicated_rng a dedicated RNG with exclusive access
 	 * @return vector with scattered rays
 	*/
 	vector<Ray> Scatter( const RayScattering& scattering_information, const VoxelData& voxel_data, const double distance_traveled_mm, 
-											 const TomographyProperties& tomography_properties, const Point3D& new_origin, RandomNumberGenerator& dedicated_rng );
+											 const TomographyProperties& tomography_properties, const Point3D& new_origin, ScatteringSearch& search,
+											 RandomNumberGenerator& dedicated_rng );
+
+	/*!
+	 * @brief get the photons of this scattering source which are expected to be scattered in given direction
+	 * @details used for forced detection. This ray must be a scattering source created by Scatter()
+	 * @param scattering_information scattering properties
+	 * @param new_direction direction of the scattered ray
+	 * @param covered_angle angle covered by the target pixel seen from this ray's origin
+	 * @param pixel_index index of target pixel
+	 * @return scattered ray when scattering in given direction is possible
+	*/
+	optional<Ray> GetForcedScatteredRay( const RayScattering& scattering_information, const Unitvector3D& new_direction, 
+																			 const double covered_angle, const size_t pixel_index ) const;
 
 	/*!
 	 * @brief set expected pixel index
@@ -289,6 +359,20 @@ class Ray : public Line{
 	RayProperties properties_;			/*!< properties of ray*/
 
 
+	/*!
+	 * @brief get the expected scattering inside a voxel
+	 * @details the scattering source's spectrum contains all photons expected to be scattered. 
+	 * The direction is the direction of this ray. This ray's spectrum is reduced by the expected amount
+	 * @param voxel_coefficient_factor voxel's absorption with respect to water's absorption
+	 * @param distance_traveled_mm distance traveled in voxel
+	 * @param tomography_properties properties of tomogrpahy
+	 * @param new_origin point where scattering occured
+	 * @return ray as scattering source
+	*/
+	Ray GetScatteringSource( const double voxel_coefficient_factor, const double distance_traveled_mm, 
+													 const TomographyProperties& tomography_properties, const Point3D& new_origin );
+
+
 	#ifdef TRANSMISSION_TRACKING
 	public:
 	RayTrace& ray_tracing( void ){ return properties_.ray_tracing; };
@@ -11,8 +11,14 @@
    Includes
 *********************************************************************/
 
+#include <bit>
+#include <map>
+#include <mutex>
+
 #include "rayScattering.h"
 #include "simulation.h"
+#include "serialization.h"
+#include "persistingObject.h"
 
 
 /*********************************************************************
@@ -20,11 +26,20 @@
 *********************************************************************/
 
 
+const string RayScattering::FILE_PREAMBLE{ "RAY_SCATTERING_FILE_PREAMBLE_Ver01" };
+
+const string ScatteringCrossSection::FILE_PREAMBLE{ "SCATTERING_CROSS_SECTION_FILE_PREAMBLE_Ver01" };
+
+RayScattering::RayScattering( void ) :
+	RayScattering{ 3, NumberRange{ minimum_energy_in_tube_spectrum, maximum_energy_in_tube_spectrum }, 2, Unitvector3D{}, 0. }
+{}
+
 RayScattering::RayScattering(	const size_t number_of_angles, 
 															const NumberRange energy_range, 
 															const size_t number_of_energies, 
 															const Unitvector3D scattering_normal, 
 															const double maximum_angle_to_lie_in_scatter_plane ) :
+	key_( GetKey( number_of_angles, energy_range, number_of_energies, maximum_angle_to_lie_in_scatter_plane ) ),
 	number_of_energies_( ForcePositive( number_of_energies ) ),
 	angle_resolution_( ( 2. * PI ) / static_cast<double>( number_of_angles - 1 ) ),
 	energy_range_( energy_range ),
@@ -66,15 +81,155 @@ RayScattering::RayScattering(	const size_t number_of_angles,
 		}
 		scattering_angle_distributions_.emplace_back( energy, 
 																			PropabilityDistribution{ pseudo_distribution } );
+
+		// normalise the pseudo propabilities to get each angle's propability
+		double propability_sum = 0.;
+		for( const Tuple2D& angle_and_propability : pseudo_distribution )
+			propability_sum += angle_and_propability.y;
+
+		vector<double> angle_propabilities( number_of_angles, 0. );
+		double in_plane_propability = 0.;
+
+		// angle index is skipped once for duplicate middle angle
+		size_t angle_index = 0;
+		for( size_t point_index = 0; point_index < pseudo_distribution.size(); point_index++ ){
+			
+			const double angle_propability = pseudo_distribution.at( point_index ).y / propability_sum;
+			angle_propabilities.at( angle_index ) += angle_propability;
+
+			if( std::abs( pseudo_distribution.at( point_index ).x ) <= max_angle_to_lie_in_scatter_plane_ )
+				in_plane_propability += angle_propability;
+
+			if( point_index != ( number_of_angles - 1 ) / 2 ) angle_index++;
+		}
+
+		angle_propabilities_.push_back( std::move( angle_propabilities ) );
+		in_plane_propabilities_.push_back( in_plane_propability );
+	}
+}
+
+RayScattering::RayScattering( const vector<char>& binary_data, vector<char>::const_iterator& current_byte ) :
+	key_( DeSerializeBuildIn<uint64_t>( 0, binary_data, current_byte ) ),
+	number_of_energies_( DeSerializeBuildIn<size_t>( 1, binary_data, current_byte ) ),
+	angle_resolution_( DeSerializeBuildIn<double>( 1., binary_data, current_byte ) ),
+	energy_range_( binary_data, current_byte ),
+	energy_resolution_( DeSerializeBuildIn<double>( 1., binary_data, current_byte ) ),
+	scattering_plane_normal_( Unitvector3D{} ),
+	max_angle_to_lie_in_scatter_plane_( DeSerializeBuildIn<double>( 0., binary_data, current_byte ) )
+{
+	const size_t number_of_angles = DeSerializeBuildIn<size_t>( 0, binary_data, current_byte );
+
+	for( size_t energy_index = 0; energy_index < number_of_energies_; energy_index++ ){
+
+		const double energy = DeSerializeBuildIn<double>( 0., binary_data, current_byte );
+		scattering_angle_distributions_.emplace_back( energy, PropabilityDistribution{ binary_data, current_byte } );
+
+		vector<double> angle_propabilities( number_of_angles, 0. );
+		for( double& angle_propability : angle_propabilities )
+			angle_propability = DeSerializeBuildIn<double>( 0., binary_data, current_byte );
+		angle_propabilities_.push_back( std::move( angle_propabilities ) );
+
+		in_plane_propabilities_.push_back( DeSerializeBuildIn<double>( 1., binary_data, current_byte ) );
+	}
+}
+
+size_t RayScattering::Serialize( vector<char>& binary_data ) const{
+
+	size_t number_of_bytes = 0;
+	number_of_bytes += SerializeBuildIn<uint64_t>( key_, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( number_of_energies_, binary_data );
+	number_of_bytes += SerializeBuildIn<double>( angle_resolution_, binary_data );
+	number_of_bytes += energy_range_.Serialize( binary_data );
+	number_of_bytes += SerializeBuildIn<double>( energy_resolution_, binary_data );
+	number_of_bytes += SerializeBuildIn<double>( max_angle_to_lie_in_scatter_plane_, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( angle_propabilities_.empty() ? 0 : angle_propabilities_.front().size(), binary_data );
+
+	for( size_t energy_index = 0; energy_index < number_of_energies_; energy_index++ ){
+		number_of_bytes += SerializeBuildIn<double>( scattering_angle_distributions_.at( energy_index ).first, binary_data );
+		number_of_bytes += scattering_angle_distributions_.at( energy_index ).second.Serialize( binary_data );
+		for( const double angle_propability : angle_propabilities_.at( energy_index ) )
+			number_of_bytes += SerializeBuildIn<double>( angle_propability, binary_data );
+		number_of_bytes += SerializeBuildIn<double>( in_plane_propabilities_.at( energy_index ), binary_data );
+	}
+
+	return number_of_bytes;
+}
+
+RayScattering RayScattering::GetCached( const size_t number_of_angles, const NumberRange energy_range, const size_t number_of_energies, 
+																				const Unitvector3D scatter_plane_normal, const double max_angle_to_lie_in_plane ){
+
+	// tables calculated or loaded during this session
+	static std::map<uint64_t, RayScattering> memorised_tables;
+	static std::mutex memorised_tables_mutex;
+
+	const uint64_t key = GetKey( number_of_angles, energy_range, number_of_energies, max_angle_to_lie_in_plane );
+
+	RayScattering scattering_information;
+	{
+		std::lock_guard<std::mutex> lock( memorised_tables_mutex );
+
+		auto memorised_table = memorised_tables.find( key );
+		if( memorised_table == memorised_tables.end() ){
+
+			const string file_name = "rayScattering_" + std::to_string( key ) + ".scattering";
+			PersistingObject<RayScattering> stored_tables{ RayScattering{}, file_name.c_str(), true };
+
+			if( !stored_tables.was_loaded() || stored_tables.key() != key ){
+				stored_tables = RayScattering{ number_of_angles, energy_range, number_of_energies, scatter_plane_normal, max_angle_to_lie_in_plane };
+				stored_tables.Save( PROGRAM_STATE().GetAbsolutePath( file_name ), true );
+			}
+
+			memorised_table = memorised_tables.emplace( key, static_cast<RayScattering>( stored_tables ) ).first;
+		}
+
+		scattering_information = memorised_table->second;
 	}
+
+	// the normal belongs to the caller's coordinate system
+	scattering_information.scattering_plane_normal_ = scatter_plane_normal;
+	return scattering_information;
+}
+
+uint64_t RayScattering::GetKey( const size_t number_of_angles, const NumberRange energy_range, const size_t number_of_energies, 
+																const double max_angle_to_lie_in_plane ){
+
+	uint64_t key = RandomNumberGenerator::CombineIdentifiers( number_of_angles, number_of_energies );
+	key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( energy_range.start() ) );
+	key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( energy_range.end() ) );
+	key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( max_angle_to_lie_in_plane ) );
+
+	return key;
+}
+
+size_t RayScattering::GetEnergyIndex( const double energy ) const{
+	return ForceToMax( static_cast<size_t>( floor( ForcePositive( energy - energy_range_.start() ) / energy_resolution_ + 0.5 ) ), 
+										 scattering_angle_distributions_.size() - 1 );
 }
 
 double RayScattering::GetRandomAngle( const double energy, RandomNumberGenerator& dedicated_rng ) const{
+	return GetAngle( energy, dedicated_rng.GetUniformNumber() );
+}
+
+double RayScattering::GetAngle( const double energy, const double uniform_number ) const{
 
 	const size_t distributionIndex = ForceToMax( static_cast<size_t>( floor( ( energy - energy_range_.start() )  / energy_resolution_ + 0.5 ) ), scattering_angle_distributions_.size() - 1 );
 
-	return scattering_angle_distributions_.at( distributionIndex ).second.GetRandomNumber( dedicated_rng );
+	return scattering_angle_distributions_.at( distributionIndex ).second.GetValue( uniform_number );
+
+}
+
+double RayScattering::GetAnglePropability( const double energy, const double angle ) const{
+
+	const vector<double>& angle_propabilities = angle_propabilities_.at( GetEnergyIndex( energy ) );
+
+	const size_t angle_index = ForceToMax( static_cast<size_t>( floor( 
+		ForcePositive( angle + PI ) / angle_resolution_ + 0.5 ) ), angle_propabilities.size() - 1 );
+
+	return angle_propabilities.at( angle_index );
+}
 
+double RayScattering::GetPropabilityToLieInPlane( const double energy ) const{
+	return in_plane_propabilities_.at( GetEnergyIndex( energy ) );
 }
 
 ScatteringCrossSection& ScatteringCrossSection::GetInstance( void ){
@@ -95,9 +250,68 @@ double ScatteringCrossSection::GetCrossSection( const double energy ) const{
 ScatteringCrossSection::ScatteringCrossSection( void ) : 
 	number_of_energies_( static_cast<size_t>( ( ( maximum_energy_in_tube_spectrum - minimum_energy_in_tube_spectrum ) / desired_energy_resolution_eV ) ) + 1 ),
 	energy_resolution_( ( maximum_energy_in_tube_spectrum - minimum_energy_in_tube_spectrum ) / static_cast<double>( number_of_energies_ - 1 ) ),
-	cross_sections_( number_of_energies_, Tuple2D{} )
+	cross_sections_( number_of_energies_, Tuple2D{} ),
+	max_cross_section_( 0. )
 {
-	auto cross_sections_collision = cross_sections_;
+	const path file_path = PROGRAM_STATE().GetAbsolutePath( "scatteringCrossSection_" + std::to_string( GetKey() ) + ".crossSection" );
+	
+	if( Load( file_path ) ) return;
+
+	Calculate();
+	Save( file_path );
+}
+
+uint64_t ScatteringCrossSection::GetKey( void ) const{
+
+	uint64_t key = RandomNumberGenerator::CombineIdentifiers( number_of_energies_, std::bit_cast<uint64_t>( energy_resolution_ ) );
+	for( const double parameter : { minimum_energy_in_tube_spectrum, maximum_energy_in_tube_spectrum, r_e_mm, reduced_energy_divisor_eV } )
+		key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( parameter ) );
+
+	return key;
+}
+
+bool ScatteringCrossSection::Load( const path file_path ){
+
+	if( !std::filesystem::exists( file_path ) ) return false;
+
+	const vector<char> binary_data = ImportSerialized( file_path );
+	vector<char>::const_iterator current_byte = binary_data.begin();
+
+	if( !IsValidBinaryData( FILE_PREAMBLE, binary_data, current_byte ) ) return false;
+	
+	// file belongs to other energies or constants
+	if( DeSerializeBuildIn<uint64_t>( 0, binary_data, current_byte ) != GetKey() ) return false;
+	if( DeSerializeBuildIn<size_t>( 0, binary_data, current_byte ) != number_of_energies_ ) return false;
+	if( static_cast<size_t>( binary_data.end() - current_byte ) != 2 * number_of_energies_ * sizeof( double ) ) return false;
+
+	double max_cross_section = 0.;
+	for( Tuple2D& cross_section : cross_sections_ ){
+		cross_section.x = DeSerializeBuildIn<double>( 0., binary_data, current_byte );
+		cross_section.y = DeSerializeBuildIn<double>( 0., binary_data, current_byte );
+		max_cross_section = std::max( max_cross_section, cross_section.y );
+	}
+	max_cross_section_ = max_cross_section;
+
+	return true;
+}
+
+bool ScatteringCrossSection::Save( const path file_path ) const{
+
+	vector<char> binary_data;
+	SerializeBuildIn<string>( FILE_PREAMBLE, binary_data );
+	SerializeBuildIn<uint64_t>( GetKey(), binary_data );
+	SerializeBuildIn<size_t>( number_of_energies_, binary_data );
+	
+	for( const Tuple2D& cross_section : cross_sections_ ){
+		SerializeBuildIn<double>( cross_section.x, binary_data );
+		SerializeBuildIn<double>( cross_section.y, binary_data );
+	}
+
+	return ExportSerialized( file_path, binary_data );
+}
+
+void ScatteringCrossSection::Calculate( void ){
+
 	for( size_t current_energy_index = 0; current_energy_index < number_of_energies_; current_energy_index++ ){
 			
 		const double energy_eV = ( minimum_energy_in_tube_spectrum + static_cast<double>( current_energy_index ) * energy_resolution_ );
@@ -115,6 +329,7 @@ ScatteringCrossSection::ScatteringCrossSection( void ) :
 									);
 
 		cross_sections_.at( current_energy_index ) = Tuple2D{ energy_eV, collision_cross_section };
+		max_cross_section_ = std::max( max_cross_section_, collision_cross_section );
 	}
 }
 
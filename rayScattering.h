@@ -31,6 +31,13 @@ class RayScattering{
 
 	public:
 
+	static const string FILE_PREAMBLE; /*!< string to prepend to file when storing as file*/
+
+	/*!
+	 * @brief default constructor
+	*/
+	RayScattering( void );
+
 	/*!
 	 * @brief constructor
 	 * @param number_of_angles how many angles in the interval from -pi to pi should be calculated
@@ -42,6 +49,50 @@ class RayScattering{
 	RayScattering(	const size_t number_of_angles, const NumberRange energy_range, const size_t number_of_energies, 
 					const Unitvector3D scatter_plane_normal, const double max_angle_to_lie_in_plane );
 
+	/*!
+	 * @brief constructor from serialized data
+	 * @details the scattering plane normal is not stored and must be set after construction
+	 * @param binary_data reference to vector with binary data
+	 * @param current_byte iterator to start of data in vector
+	*/
+	RayScattering( const vector<char>& binary_data, vector<char>::const_iterator& current_byte );
+
+	/*!
+	 * @brief serialize this object
+	 * @param binary_data reference to vector where data will be appended
+	 * @return written bytes
+	*/
+	size_t Serialize( vector<char>& binary_data ) const;
+
+	/*!
+	 * @brief get scattering information from memory, program storage or calculate and store it
+	 * @param number_of_angles how many angles in the interval from -pi to pi should be calculated
+	 * @param energy_range how large is the energy range to calculate propabilities for
+	 * @param number_of_energies for how many energies should  the probabilities be calculated
+	 * @param scatter_plane_normal normal of the plane in which rays are scattered
+	 * @param max_angle_to_lie_in_plane maximum angle between a scattered ray and the scattering plane for a ascttered ray to not be discarded
+	 * @return scattering information
+	*/
+	static RayScattering GetCached( const size_t number_of_angles, const NumberRange energy_range, const size_t number_of_energies, 
+																	const Unitvector3D scatter_plane_normal, const double max_angle_to_lie_in_plane );
+
+	/*!
+	 * @brief get key identifying the parameters the tables depend on
+	 * @param number_of_angles amount of angles
+	 * @param energy_range energy range
+	 * @param number_of_energies amount of energies
+	 * @param max_angle_to_lie_in_plane maximum angle to the scattering plane
+	 * @return key
+	*/
+	static uint64_t GetKey( const size_t number_of_angles, const NumberRange energy_range, const size_t number_of_energies, 
+													const double max_angle_to_lie_in_plane );
+
+	/*!
+	 * @brief get key of tables
+	 * @return key
+	*/
+	uint64_t key( void ) const{ return key_; };
+
 	/*!
 	 * @brief get scattering plane normal
 	 * @return plane normal
@@ -68,19 +119,53 @@ class RayScattering{
 	*/
 	double GetRandomAngle( const double energy_eV, RandomNumberGenerator& dedicated_rng ) const;
 
+	/*!
+	 * @brief get the angle to given energy for a uniform number
+	 * @param energy_eV mean energy of ray
+	 * @param uniform_number number in [0, 1)
+	 * @return angle
+	*/
+	double GetAngle( const double energy_eV, const double uniform_number ) const;
+
+	/*!
+	 * @brief get the propability that a scattered photon's angle lies in the angle bin of given angle
+	 * @param energy_eV energy of photon
+	 * @param angle scattering angle between -pi and pi
+	 * @return propability of angle bin
+	*/
+	double GetAnglePropability( const double energy_eV, const double angle ) const;
+
+	/*!
+	 * @brief get the propability that a scattered photon lies in the scattering plane
+	 * @param energy_eV energy of photon
+	 * @return propability that the angle to the scattering plane is not greater than the maximum angle
+	*/
+	double GetPropabilityToLieInPlane( const double energy_eV ) const;
+
 
 	private:
 
+	uint64_t key_;										/*!< key of the parameters used for calculation*/
 	size_t number_of_energies_;				/*!< amount of energies*/
 	double angle_resolution_;					/*!< angle resolution*/
 	NumberRange energy_range_;				/*!< range of energies*/
 	double energy_resolution_;				/*!< energy resolution*/
 
 	vector<pair<double, PropabilityDistribution>> scattering_angle_distributions_;	/*!< vector with energies and the correspondeing angle distribution*/
+	vector<vector<double>> angle_propabilities_;		/*!< propabilities of each angle bin for each energy*/
+	vector<double> in_plane_propabilities_;					/*!< propability of a scattered photon to lie in the scattering plane for each energy*/
 
 	Unitvector3D scattering_plane_normal_;				/*!< rotation normal for scattered rays*/
  
 	double max_angle_to_lie_in_scatter_plane_;		/*!< maximum angle between a scattered ray and the scattering plane for a ascttered ray to not be discarded*/
+
+
+	/*!
+	 * @brief get index of distribution for energy
+	 * @param energy_eV energy
+	 * @return index of the energy closest to given energy
+	*/
+	size_t GetEnergyIndex( const double energy_eV ) const;
  };
 
 
@@ -93,6 +178,7 @@ class ScatteringCrossSection{
 	public:
 	
 	static constexpr double desired_energy_resolution_eV = 1000;			/*!< the desired energy resolution*/
+	static const string FILE_PREAMBLE;																/*!< string to prepend to file when storing as file*/
 	
 	/*!
 	 * @brief get single instance
@@ -122,16 +208,49 @@ class ScatteringCrossSection{
 	 */
 	vector<double> GetCrossSections( void ) const;
 
+	/*!
+	 * @brief get the largest cross section of all energies
+	 * @return largest cross section in mm^2
+	*/
+	double max_cross_section( void ) const{ return max_cross_section_; };
+
 
 	private:
 	
 	size_t number_of_energies_;				/*!< amount of energies calculated*/
 	double energy_resolution_;				/*!< resolution of energies*/
 	vector<Tuple2D> cross_sections_;	/*!< vector with energies in eV and corresponding cross sections in mm^2 */
+	double max_cross_section_;				/*!< largest cross section in mm^2*/
 
 	/*!
 	 * @brief constructor
+	 * @details loads the table from the program state or calculates and stores it
 	*/
 	ScatteringCrossSection( void );
 
+	/*!
+	 * @brief get key of the table's energy range and electron constants
+	 * @return key
+	*/
+	uint64_t GetKey( void ) const;
+
+	/*!
+	 * @brief load table from the program state
+	 * @param file_path path to stored table
+	 * @return true when a table with the same key was loaded
+	*/
+	bool Load( const path file_path );
+
+	/*!
+	 * @brief calculate table
+	*/
+	void Calculate( void );
+
+	/*!
+	 * @brief store table in the program state
+	 * @param file_path path to store table at
+	 * @return true at success
+	*/
+	bool Save( const path file_path ) const;
+
  };
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*********************************************************************
+ * @file   reconstructionJob.cpp
+ * @brief  implementations
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "reconstructionJob.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+ReconstructionJob::ReconstructionJob( const Projections projections, const BackprojectionFilter::TYPE filter_type ) :
+	projections_( projections ),
+	filter_type_( filter_type ),
+	progress_token_{},
+	filtered_projections_{},
+	backprojection_{},
+	finished_{ false },
+	worker_{ &ReconstructionJob::Reconstruct, this }
+{}
+
+ReconstructionJob::~ReconstructionJob( void ){
+	progress_token_.RequestStop();
+	if( worker_.joinable() ) worker_.join();
+}
+
+void ReconstructionJob::Reconstruct( void ){
+
+	FilteredProjections filtered_projections{ projections_, filter_type_, &progress_token_ };
+	
+	// results of a stopped stage are incomplete
+	if( !progress_token_.stop_requested() ){
+		Backprojection backprojection{ filtered_projections, &progress_token_ };
+
+		if( !progress_token_.stop_requested() ){
+			filtered_projections_ = std::move( filtered_projections );
+			backprojection_ = std::move( backprojection );
+		}
+	}
+
+	finished_.store( true );
+}
@@ -0,0 +1,111 @@
+#pragma once
+/*********************************************************************
+ * @file   reconstructionJob.h
+ * @brief  class to filter and backproject projections in the background
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <atomic>
+#include <thread>
+
+#include "generel.h"
+#include "projections.h"
+#include "filteredProjections.h"
+#include "backprojection.h"
+#include "progressToken.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for a reconstruction running on its own thread
+ * @details the projections are filtered and backprojected. Reconstruction starts with construction
+*/
+class ReconstructionJob{
+
+	public:
+
+	/*!
+	 * @brief constructor
+	 * @param projections projections to reconstruct
+	 * @param filter_type type of filter
+	*/
+	ReconstructionJob( const Projections projections, const BackprojectionFilter::TYPE filter_type );
+
+	/*!
+	 * @brief destructor
+	 * @details stops the reconstruction and waits for the thread
+	*/
+	~ReconstructionJob( void );
+
+	/*!
+	 * @brief deleted
+	*/
+	ReconstructionJob( const ReconstructionJob& ) = delete;
+
+	/*!
+	 * @brief deleted
+	*/
+	ReconstructionJob& operator=( const ReconstructionJob& ) = delete;
+
+	/*!
+	 * @brief request the reconstruction to stop
+	*/
+	void Stop( void ){ progress_token_.RequestStop(); };
+
+	/*!
+	 * @brief check if the reconstruction has finished
+	 * @return true when the thread finished
+	*/
+	bool finished( void ) const{ return finished_.load(); };
+
+	/*!
+	 * @brief get progress of the reconstruction
+	 * @return token
+	*/
+	const ProgressToken& progress_token( void ) const{ return progress_token_; };
+
+	/*!
+	 * @brief get the filtered projections
+	 * @details only valid after the job has finished
+	 * @return filtered projections when the reconstruction was not stopped
+	*/
+	optional<FilteredProjections>& filtered_projections( void ){ return filtered_projections_; };
+
+	/*!
+	 * @brief get the reconstructed image
+	 * @details only valid after the job has finished
+	 * @return image when the reconstruction was not stopped
+	*/
+	optional<Backprojection>& backprojection( void ){ return backprojection_; };
+
+
+	private:
+
+	Projections projections_;													/*!< projections to reconstruct*/
+	BackprojectionFilter::TYPE filter_type_;					/*!< type of filter*/
+
+	ProgressToken progress_token_;										/*!< token for progress and stop*/
+	optional<FilteredProjections> filtered_projections_;	/*!< filtered projections*/
+	optional<Backprojection> backprojection_;					/*!< reconstructed image*/
+	std::atomic<bool> finished_;											/*!< flag for finished thread*/
+
+	std::thread worker_;															/*!< thread running the reconstruction. Started last*/
+
+
+	/*!
+	 * @brief filter and backproject the projections
+	*/
+	void Reconstruct( void );
+
+};
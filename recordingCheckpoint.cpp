@@ -0,0 +1,115 @@
+/*********************************************************************
+ * @file   recordingCheckpoint.cpp
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <filesystem>
+#include "recordingCheckpoint.h"
+#include "programState.h"
+#include "serialization.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+
+const string RecordingCheckpoint::FILE_PREAMBLE{ "RECORDING_CHECKPOINT_FILE_PREAMBLE_Ver01" };
+
+RecordingCheckpoint::RecordingCheckpoint( void ) :
+	key_( 0 ),
+	slice_index_( 0 ),
+	number_of_completed_frames_( 0 )
+{}
+
+RecordingCheckpoint::RecordingCheckpoint( const uint64_t key, const size_t slice_index, const size_t number_of_completed_frames, 
+																					const vector<Projections>& completed_slices, const Projections& projections ) :
+	key_( key ),
+	slice_index_( slice_index ),
+	number_of_completed_frames_( number_of_completed_frames ),
+	completed_slices_( completed_slices ),
+	projections_( projections )
+{}
+
+RecordingCheckpoint::RecordingCheckpoint( const vector<char>& binary_data, vector<char>::const_iterator& current_byte ) :
+	key_( DeSerializeBuildIn<uint64_t>( 0, binary_data, current_byte ) ),
+	slice_index_( DeSerializeBuildIn<size_t>( 0, binary_data, current_byte ) ),
+	number_of_completed_frames_( DeSerializeBuildIn<size_t>( 0, binary_data, current_byte ) )
+{
+	const size_t number_of_completed_slices = DeSerializeBuildIn<size_t>( 0, binary_data, current_byte );
+	
+	for( size_t slice_index = 0; slice_index < number_of_completed_slices; slice_index++ )
+		completed_slices_.emplace_back( binary_data, current_byte );
+
+	projections_ = Projections{ binary_data, current_byte };
+}
+
+size_t RecordingCheckpoint::Serialize( vector<char>& binary_data ) const{
+	
+	size_t number_of_bytes = 0;
+	number_of_bytes += SerializeBuildIn<uint64_t>( key_, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( slice_index_, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( number_of_completed_frames_, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( completed_slices_.size(), binary_data );
+	
+	for( const Projections& slice : completed_slices_ )
+		number_of_bytes += slice.Serialize( binary_data );
+
+	number_of_bytes += projections_.Serialize( binary_data );
+
+	return number_of_bytes;
+}
+
+path RecordingCheckpoint::GetPath( const uint64_t key ){
+	return PROGRAM_STATE().GetAbsolutePath( "recordingCheckpoint_" + std::to_string( key ) + ".checkpoint" );
+}
+
+optional<RecordingCheckpoint> RecordingCheckpoint::Load( const uint64_t key ){
+
+	const path file_path = GetPath( key );
+	if( !std::filesystem::exists( file_path ) ) return {};
+
+	const vector<char> binary_data = ImportSerialized( file_path );
+	vector<char>::const_iterator current_byte = binary_data.begin();
+
+	if( !IsValidBinaryData( FILE_PREAMBLE, binary_data, current_byte ) ) return {};
+
+	RecordingCheckpoint checkpoint{ binary_data, current_byte };
+	
+	// file belongs to another recording
+	if( checkpoint.key() != key ) return {};
+
+	return checkpoint;
+}
+
+void RecordingCheckpoint::Remove( const uint64_t key ){
+	std::error_code error;
+	std::filesystem::remove( GetPath( key ), error );
+}
+
+bool RecordingCheckpoint::Save( void ) const{
+	
+	vector<char> binary_data;
+	SerializeBuildIn<string>( FILE_PREAMBLE, binary_data );
+	Serialize( binary_data );
+
+	// a crash while writing must not destroy the previous checkpoint
+	const path file_path = GetPath( key_ );
+	path temporary_path = file_path;
+	temporary_path += ".tmp";
+
+	if( !ExportSerialized( temporary_path, binary_data ) ) return false;
+	
+	std::error_code error;
+	std::filesystem::rename( temporary_path, file_path, error );
+	
+	return !error;
+}
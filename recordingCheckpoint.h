@@ -0,0 +1,134 @@
+#pragma once
+/*********************************************************************
+ * @file   recordingCheckpoint.h
+ * @brief  class for checkpoints of running recordings
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "generel.h"
+#include "projections.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for the state of a recording after completed frames
+ * @details random numbers only depend on the seed, the frame and the ray. The gantry's pose follows from the slice and frame.
+ * Completed slices, the partial projections of the current slice and the amount of completed frames are therefore 
+ * sufficient to continue a recording
+*/
+class RecordingCheckpoint{
+
+	public:
+
+	static const string FILE_PREAMBLE;							/*!< string to prepend to file when storing as file*/
+	static constexpr double checkpoint_interval_s = 60.;	/*!< minimum time between two checkpoints in seconds*/
+
+
+	/*!
+	 * @brief default constructor
+	*/
+	RecordingCheckpoint( void );
+
+	/*!
+	 * @brief constructor
+	 * @param key key identifying the recording
+	 * @param slice_index index of the current slice
+	 * @param number_of_completed_frames amount of radiated frames of the current slice which are merged into its projections
+	 * @param completed_slices projections of all completed slices
+	 * @param projections partial projections of the current slice
+	*/
+	RecordingCheckpoint( const uint64_t key, const size_t slice_index, const size_t number_of_completed_frames, 
+											 const vector<Projections>& completed_slices, const Projections& projections );
+
+	/*!
+	 * @brief constructor from serialized data
+	 * @param binary_data reference to vector with binary data
+	 * @param current_byte iterator to start of data in vector
+	*/
+	RecordingCheckpoint( const vector<char>& binary_data, vector<char>::const_iterator& current_byte );
+
+	/*!
+	 * @brief serialize this object
+	 * @param binary_data reference to vector where data will be appended
+	 * @return written bytes
+	*/
+	size_t Serialize( vector<char>& binary_data ) const;
+
+	/*!
+	 * @brief load checkpoint of recording from program storage
+	 * @param key key identifying the recording
+	 * @return checkpoint when one exists for key
+	*/
+	static optional<RecordingCheckpoint> Load( const uint64_t key );
+
+	/*!
+	 * @brief remove the checkpoint of recording from program storage
+	 * @param key key identifying the recording
+	*/
+	static void Remove( const uint64_t key );
+
+	/*!
+	 * @brief save checkpoint to program storage
+	 * @details the file is written completely before it replaces the previous checkpoint
+	 * @return true at success
+	*/
+	bool Save( void ) const;
+
+	/*!
+	 * @brief get key of recording
+	 * @return key
+	*/
+	uint64_t key( void ) const{ return key_; };
+
+	/*!
+	 * @brief get index of current slice
+	 * @return slice index
+	*/
+	size_t slice_index( void ) const{ return slice_index_; };
+
+	/*!
+	 * @brief get amount of completed frames of current slice
+	 * @return amount of frames
+	*/
+	size_t number_of_completed_frames( void ) const{ return number_of_completed_frames_; };
+
+	/*!
+	 * @brief get completed slices
+	 * @return projections of completed slices
+	*/
+	const vector<Projections>& completed_slices( void ) const{ return completed_slices_; };
+
+	/*!
+	 * @brief get partial projections of current slice
+	 * @return projections
+	*/
+	const Projections& projections( void ) const{ return projections_; };
+
+
+	private:
+
+	uint64_t key_;															/*!< key identifying the recording*/
+	size_t slice_index_;												/*!< index of current slice*/
+	size_t number_of_completed_frames_;					/*!< amount of completed frames of current slice*/
+	vector<Projections> completed_slices_;			/*!< projections of completed slices*/
+	Projections projections_;										/*!< partial projections of current slice*/
+
+
+	/*!
+	 * @brief get path of checkpoint file
+	 * @param key key identifying the recording
+	 * @return path in program storage
+	*/
+	static path GetPath( const uint64_t key );
+};
@@ -0,0 +1,162 @@
+/*********************************************************************
+ * @file   scanConfiguration.cpp
+ * @brief  implementations
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <fstream>
+#include <stdexcept>
+
+#include "scanConfiguration.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+const vector<string> ScanConfiguration::parameter_names{
+	"anode_voltage_V", "anode_current_A", "anode_material", "rays_per_pixel", "tube_filter", "filter_cut_of_energy_eV", "filter_gradient",
+	"number_of_angles", "number_of_distances", "measuring_field_size_mm",
+	"detector_focus_distance_mm", "anti_scattering_structure", "max_ray_angle_deg",
+	"name", "scattering", "max_scattering_occurrences", "scatter_propability_correction", "scattered_ray_absorption_factor", 
+	"simple_absorption", "simulation_quality", "forced_detection", "max_rays_per_iteration", "random_seed", "quasi_random_sampling", 
+	"scatter_kernel",
+	"filter", "z_position_mm"
+};
+
+
+ScanConfiguration::ScanConfiguration( void ) :
+	tube_properties{},
+	projections_properties{},
+	detector_properties{ 2., 1000. },
+	tomography_properties{},
+	filter_type( BackprojectionFilter::TYPE::ramLak ),
+	z_position( 0. )
+{}
+
+bool ScanConfiguration::Set( const string name, const string value ){
+
+	// invalid numbers throw
+	try{
+		const auto flag = [ & ]( void ){ 
+			if( value != "0" && value != "1" && value != "true" && value != "false" ) throw std::invalid_argument{ value };
+			return value == "1" || value == "true"; };
+		const auto number = [ & ]( void ){ return ConvertToNumber<double>( value ); };
+		const auto natural_number = [ & ]( void ){ 
+			if( number() < 0. ) throw std::invalid_argument{ value }; 
+			return static_cast<size_t>( ConvertToNumber<unsigned long long int>( value ) ); };
+
+		XRayTubeProperties& tube = tube_properties;
+		const ProjectionsProperties& projections = projections_properties;
+		TomographyProperties& tomography = tomography_properties;
+
+		// tube
+		if( name == "anode_voltage_V" ) tube.anode_voltage_V = number();
+		else if( name == "anode_current_A" ) tube.anode_current_A = number();
+		else if( name == "anode_material" ){
+			const auto material = std::find_if( XRayTubeProperties::materials.cbegin(), XRayTubeProperties::materials.cend(), 
+																					 [ & ]( const auto& material ){ return material.second.first == value; } );
+			if( material == XRayTubeProperties::materials.cend() ) return false;
+			tube.anode_material = material->first;
+		}
+		else if( name == "rays_per_pixel" ) tube.number_of_rays_per_pixel_ = ForceToMin1( natural_number() );
+		else if( name == "tube_filter" ) tube.has_filter_ = flag();
+		else if( name == "filter_cut_of_energy_eV" ) tube.filter_cut_of_energy = ForceRange( number(), 0., 120000. );
+		else if( name == "filter_gradient" ) tube.filter_gradient = ForceRange( number(), .1, 10. );
+		
+		// projections
+		else if( name == "number_of_angles" ) 
+			projections_properties = ProjectionsProperties{ natural_number(), projections.number_of_distances(), projections.measuring_field_size() };
+		else if( name == "number_of_distances" ) 
+			projections_properties = ProjectionsProperties{ projections.number_of_projections(), natural_number(), projections.measuring_field_size() };
+		else if( name == "measuring_field_size_mm" ) 
+			projections_properties = ProjectionsProperties{ projections.number_of_projections(), projections.number_of_distances(), number() };
+
+		// detector
+		else if( name == "detector_focus_distance_mm" ) detector_properties.detector_focus_distance = number();
+		else if( name == "anti_scattering_structure" ) detector_properties.has_anti_scattering_structure = flag();
+		else if( name == "max_ray_angle_deg" ) detector_properties.max_angle_allowed_by_structure = number() / 360. * 2. * PI;
+
+		// tomography
+		else if( name == "name" ) tomography.name = value;
+		else if( name == "scattering" ) tomography.scattering_enabled = flag();
+		else if( name == "max_scattering_occurrences" ) tomography.max_scattering_occurrences = natural_number();
+		else if( name == "scatter_propability_correction" ) tomography.scatter_propability_correction = number();
+		else if( name == "scattered_ray_absorption_factor" ) tomography.scattered_ray_absorption_factor = number();
+		else if( name == "simple_absorption" ) tomography.use_simple_absorption = flag();
+		else if( name == "simulation_quality" ) tomography.simulation_quality = natural_number();
+		else if( name == "forced_detection" ) tomography.forced_detection = flag();
+		else if( name == "max_rays_per_iteration" ) tomography.max_rays_per_iteration = natural_number();
+		else if( name == "random_seed" ) tomography.random_seed = natural_number();
+		else if( name == "quasi_random_sampling" ) tomography.quasi_random_sampling = flag();
+		else if( name == "scatter_kernel" ) tomography.scatter_kernel_mode = flag();
+
+		// reconstruction
+		else if( name == "filter" ){
+			const auto filter = std::find_if( BackprojectionFilter::filter_types.cbegin(), BackprojectionFilter::filter_types.cend(), 
+																				[ & ]( const auto& filter ){ return filter.second == value; } );
+			if( filter == BackprojectionFilter::filter_types.cend() ) return false;
+			filter_type = filter->first;
+		}
+		else if( name == "z_position_mm" ) z_position = number();
+
+		else return false;
+	}
+	catch( const std::exception& ){
+		return false;
+	}
+
+	return true;
+}
+
+bool ScanConfiguration::Load( const path file_path, vector<string>* const invalid_lines ){
+
+	std::ifstream file{ file_path };
+	if( !file.is_open() ) return false;
+
+	const auto trim = []( const string text ){
+		const size_t start = text.find_first_not_of( " \t\r" );
+		if( start == string::npos ) return string{};
+		return text.substr( start, text.find_last_not_of( " \t\r" ) - start + 1 );
+	};
+
+	bool all_valid = true;
+	string line;
+	while( std::getline( file, line ) ){
+
+		const string trimmed_line = trim( line );
+		if( trimmed_line.empty() || trimmed_line.front() == '#' ) continue;
+
+		const size_t separator = trimmed_line.find( '=' );
+		if( separator == string::npos || !Set( trim( trimmed_line.substr( 0, separator ) ), trim( trimmed_line.substr( separator + 1 ) ) ) ){
+			all_valid = false;
+			if( invalid_lines != nullptr ) invalid_lines->push_back( trimmed_line );
+		}
+	}
+
+	return all_valid;
+}
+
+Gantry ScanConfiguration::CreateGantry( CoordinateSystem* const coordinate_system ) const{
+	return Gantry{ coordinate_system, GetCurrentTubeProperties(), projections_properties, detector_properties };
+}
+
+void ScanConfiguration::UpdateGantry( Gantry& gantry ) const{
+	gantry.UpdateTubeAndDetectorProperties( GetCurrentTubeProperties(), projections_properties, detector_properties );
+}
+
+XRayTubeProperties ScanConfiguration::GetCurrentTubeProperties( void ) const{
+
+	// recreate tube properties for the current spectrum resolution
+	return XRayTubeProperties{ tube_properties.anode_voltage_V, tube_properties.anode_current_A, tube_properties.anode_material,
+														 tube_properties.number_of_rays_per_pixel_, tube_properties.has_filter_, 
+														 tube_properties.filter_cut_of_energy, tube_properties.filter_gradient };
+}
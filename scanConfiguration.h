@@ -0,0 +1,94 @@
+#pragma once
+/*********************************************************************
+ * @file   scanConfiguration.h
+ * @brief  class for all parameters of a scan without graphical interface
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "generel.h"
+#include "xRayTube.h"
+#include "projectionsProperties.h"
+#include "detectorProperties.h"
+#include "tomography.h"
+#include "backprojectionFilter.h"
+#include "gantry.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for the parameters of acquisition and reconstruction
+ * @details parameters are set from serialized properties or from text lines "name = value". 
+ * Lines starting with '#' are comments
+*/
+class ScanConfiguration{
+
+	public:
+
+	static const vector<string> parameter_names;		/*!< names of parameters which can be set by text*/
+
+	XRayTubeProperties tube_properties;									/*!< properties of x-ray tube*/
+	ProjectionsProperties projections_properties;				/*!< properties of projections*/
+	PhysicalDetectorProperties detector_properties;			/*!< physical properties of detector*/
+	TomographyProperties tomography_properties;					/*!< properties of tomography*/
+	BackprojectionFilter::TYPE filter_type;							/*!< filter for reconstruction*/
+	double z_position;																	/*!< z-position of slice*/
+
+
+	/*!
+	 * @brief default constructor
+	 * @details defaults match the defaults of the graphical interface
+	*/
+	ScanConfiguration( void );
+
+	/*!
+	 * @brief set a parameter
+	 * @param name name of parameter
+	 * @param value value as text
+	 * @return true when name is known and value is valid
+	*/
+	bool Set( const string name, const string value );
+
+	/*!
+	 * @brief set parameters from text file
+	 * @param file_path path to file
+	 * @param invalid_lines when given lines with unknown names or invalid values are written to it
+	 * @return true when file was read and all lines are valid
+	*/
+	bool Load( const path file_path, vector<string>* const invalid_lines = nullptr );
+
+	/*!
+	 * @brief create a gantry from the properties
+	 * @details the tube's spectrum depends on the global simulation properties. They must be set before
+	 * @param coordinate_system coordinate system of gantry
+	 * @return gantry in its initial position
+	*/
+	Gantry CreateGantry( CoordinateSystem* const coordinate_system ) const;
+
+	/*!
+	 * @brief update an existing gantry to the properties
+	 * @details avoids adding coordinate systems to the tree. The global simulation properties must be set before
+	 * @param gantry gantry to update. Is in its initial position afterwards
+	*/
+	void UpdateGantry( Gantry& gantry ) const;
+
+
+	private:
+
+	/*!
+	 * @brief get tube properties with spectrum for the current simulation properties
+	 * @return tube properties
+	*/
+	XRayTubeProperties GetCurrentTubeProperties( void ) const;
+
+};
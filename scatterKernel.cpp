@@ -0,0 +1,298 @@
+/*********************************************************************
+ * @file   scatterKernel.cpp
+ * @brief  Implementations
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+
+ /*********************************************************************
+   Includes
+*********************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <map>
+#include <mutex>
+#include <numeric>
+
+#include "scatterKernel.h"
+#include "tomography.h"
+#include "model.h"
+#include "coordinateSystemTree.h"
+#include "serialization.h"
+#include "persistingObject.h"
+#include "propabilityDistribution.h"
+
+
+/*********************************************************************
+   Implementation
+*********************************************************************/
+
+const string ScatterKernel::FILE_PREAMBLE{ "SCATTER_KERNEL_FILE_PREAMBLE_Ver02" };
+
+ScatterKernel::ScatterKernel( void ) :
+	key_( 0 ),
+	thicknesses_( 0 ),
+	transmissions_( 0 ),
+	kernels_( 0 )
+{}
+
+ScatterKernel::ScatterKernel( Gantry gantry, TomographyProperties tomography_properties, const RayScattering& scattering_information ) :
+	key_( GetKey( gantry, tomography_properties ) ),
+	thicknesses_( number_of_thicknesses, 0. ),
+	transmissions_( number_of_thicknesses, 1. ),
+	kernels_( number_of_thicknesses )
+{
+
+	tomography_properties.scattering_enabled = true;
+
+	const vector<DetectorPixel> pixel_array = gantry.pixel_array();
+	const size_t number_of_pixel = pixel_array.size();
+	const vector<size_t> spatial_order = GetSpatialOrder( pixel_array );
+
+	// pencil beams through both outermost pixel. Each beam reaches all offsets to one side of it
+	const size_t first_pixel_index = static_cast<size_t>( std::find( spatial_order.cbegin(), spatial_order.cend(), 0 ) - spatial_order.cbegin() );
+	const size_t last_pixel_index = static_cast<size_t>( std::find( spatial_order.cbegin(), spatial_order.cend(), number_of_pixel - 1 ) - spatial_order.cbegin() );
+	const array<size_t, 2> pencil_pixel_indices{ first_pixel_index, last_pixel_index };
+
+	const double incident_power = gantry.tube().GetEmittedBeamPower() / static_cast<double>( number_of_pixel );
+	const double total_incident_power = incident_power * static_cast<double>( number_of_repetitions );
+
+	const Unitvector3D rotation_axis = gantry.coordinate_system()->GetEz();
+	const Point3D gantry_center{ Tuple3D{ 0, 0, 0 }, gantry.coordinate_system() };
+
+	// one system for all slabs. systems can not be removed from the tree
+	static CoordinateSystem* const slab_system = GetGlobalSystem()->CreateCopy( "Scatter kernel slab" );
+
+	const double slab_width = gantry.detector().properties().detector_focus_distance / 2.;
+	const double slab_height = gantry.detector().properties().row_width;
+
+	for( size_t thickness_index = 0; thickness_index < number_of_thicknesses; thickness_index++ ){
+
+		const double thickness = max_thickness_mm * static_cast<double>( thickness_index ) /
+																									static_cast<double>( number_of_thicknesses - 1 );
+		thicknesses_.at( thickness_index ) = thickness;
+		kernels_.at( thickness_index ) = vector<double>( 2 * number_of_pixel - 1, 0. );
+
+		// no scattering without water
+		if( thickness_index == 0 ) continue;
+
+		const size_t number_of_thickness_voxels = static_cast<size_t>( ceil( thickness / voxel_size_mm ) );
+		
+		double primary_power = 0.;
+
+		for( size_t side_index = 0; side_index < pencil_pixel_indices.size(); side_index++ ){
+
+			const size_t pencil_pixel_index = pencil_pixel_indices.at( side_index );
+			vector<bool> pencil_beam_pixel( number_of_pixel, false );
+			pencil_beam_pixel.at( pencil_pixel_index ) = true;
+
+			// slab axes in global system. thickness along the pencil beam, lateral in the gantry's plane
+			const Line pencil_beam = pixel_array.at( pencil_pixel_index ).NormalLine();
+			const Unitvector3D lateral_direction{ pencil_beam.direction() ^ rotation_axis };
+
+			const PrimitiveVector3 slab_ex = lateral_direction.GetComponents( GetGlobalSystem() );
+			const PrimitiveVector3 slab_ey = pencil_beam.direction().GetComponents( GetGlobalSystem() );
+			const PrimitiveVector3 slab_ez = rotation_axis.GetComponents( GetGlobalSystem() );
+
+			// center slab on the pencil beam where it passes the gantry's center
+			const PrimitiveVector3 slab_center = gantry_center.GetComponents( GetGlobalSystem() ) + 
+																					 pencil_beam.GetLot( gantry_center ).GetComponents( GetGlobalSystem() );
+			const PrimitiveVector3 slab_origin = slab_center -
+				( slab_ex * ( slab_width / 2. ) + slab_ey * ( thickness / 2. ) + slab_ez * ( slab_height / 2. ) );
+			slab_system->SetPrimitive( PrimitiveCoordinateSystem{ slab_origin, slab_ex, slab_ey, slab_ez } );
+
+			const Model slab{ slab_system,
+												Index3D{ number_of_lateral_voxels, number_of_thickness_voxels, 1 },
+												Tuple3D{ slab_width / static_cast<double>( number_of_lateral_voxels ),
+																 thickness / static_cast<double>( number_of_thickness_voxels ),
+																 slab_height },
+												"Water slab",
+												VoxelData{ absorption_water_Per_mm, reference_energy_for_mu_eV } };
+
+			vector<double> scattered_powers( number_of_pixel, 0. );
+
+			// repeat pencil beam to reduce noise. repetitions use different random numbers
+			for( size_t repetition = 0; repetition < number_of_repetitions; repetition++ ){
+
+				gantry.RadiateModel( slab, tomography_properties, scattering_information, pencil_beam_pixel,
+														 ( side_index * number_of_thicknesses + thickness_index ) * number_of_repetitions + repetition );
+
+				const vector<DetectorPixel> detected_pixel = gantry.pixel_array();
+				for( size_t pixel_index = 0; pixel_index < number_of_pixel; pixel_index++ ){
+					scattered_powers.at( pixel_index ) += detected_pixel.at( pixel_index ).GetDetectedPower( true );
+				}
+				primary_power += detected_pixel.at( pencil_pixel_index ).GetDetectedPower( false );
+			}
+
+			// store by spatial offset to the pencil beam's pixel. Both beams measure the offset zero
+			for( size_t pixel_index = 0; pixel_index < number_of_pixel; pixel_index++ ){
+				const size_t offset_index = spatial_order.at( pixel_index ) + number_of_pixel - 1 - spatial_order.at( pencil_pixel_index );
+				const double weight = offset_index == number_of_pixel - 1 ? 1. / static_cast<double>( pencil_pixel_indices.size() ) : 1.;
+				kernels_.at( thickness_index ).at( offset_index ) += weight * scattered_powers.at( pixel_index ) / total_incident_power;
+			}
+		}
+
+		transmissions_.at( thickness_index ) = primary_power / ( total_incident_power * static_cast<double>( pencil_pixel_indices.size() ) );
+	}
+}
+
+ScatterKernel::ScatterKernel( const vector<char>& binary_data, vector<char>::const_iterator& current_byte ) :
+	key_( DeSerializeBuildIn<uint64_t>( 0, binary_data, current_byte ) ),
+	thicknesses_( 0 ),
+	transmissions_( 0 ),
+	kernels_( 0 )
+{
+	const size_t number_of_kernels = DeSerializeBuildIn<size_t>( 0, binary_data, current_byte );
+	const size_t kernel_size = DeSerializeBuildIn<size_t>( 0, binary_data, current_byte );
+
+	for( size_t kernel_index = 0; kernel_index < number_of_kernels; kernel_index++ ){
+		thicknesses_.push_back( DeSerializeBuildIn<double>( 0., binary_data, current_byte ) );
+		transmissions_.push_back( DeSerializeBuildIn<double>( 1., binary_data, current_byte ) );
+
+		vector<double> kernel( kernel_size, 0. );
+		for( double& value : kernel ) value = DeSerializeBuildIn<double>( 0., binary_data, current_byte );
+		kernels_.push_back( std::move( kernel ) );
+	}
+}
+
+size_t ScatterKernel::Serialize( vector<char>& binary_data ) const{
+
+	size_t number_of_bytes = 0;
+	number_of_bytes += SerializeBuildIn<uint64_t>( key_, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( kernels_.size(), binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( kernels_.empty() ? 0 : kernels_.front().size(), binary_data );
+
+	for( size_t kernel_index = 0; kernel_index < kernels_.size(); kernel_index++ ){
+		number_of_bytes += SerializeBuildIn<double>( thicknesses_.at( kernel_index ), binary_data );
+		number_of_bytes += SerializeBuildIn<double>( transmissions_.at( kernel_index ), binary_data );
+		for( const double value : kernels_.at( kernel_index ) )
+			number_of_bytes += SerializeBuildIn<double>( value, binary_data );
+	}
+
+	return number_of_bytes;
+}
+
+ScatterKernel ScatterKernel::GetCached( const Gantry& gantry, const TomographyProperties& tomography_properties,
+																				const RayScattering& scattering_information ){
+
+	// kernels generated or loaded during this session. Generation uses one shared slab system so it is done under the lock
+	static std::map<uint64_t, ScatterKernel> memorised_kernels;
+	static std::mutex memorised_kernels_mutex;
+
+	const uint64_t key = GetKey( gantry, tomography_properties );
+
+	std::lock_guard<std::mutex> lock( memorised_kernels_mutex );
+
+	auto memorised_kernel = memorised_kernels.find( key );
+	if( memorised_kernel != memorised_kernels.end() )
+		return memorised_kernel->second;
+
+	const string file_name = "scatterKernel_" + std::to_string( key ) + ".kernel";
+	PersistingObject<ScatterKernel> cached_kernel{ ScatterKernel{}, file_name.c_str(), true };
+
+	if( !cached_kernel.was_loaded() || cached_kernel.key() != key ){
+		cached_kernel = ScatterKernel{ gantry, tomography_properties, scattering_information };
+		cached_kernel.Save( PROGRAM_STATE().GetAbsolutePath( file_name ), true );
+	}
+
+	return memorised_kernels.emplace( key, static_cast<ScatterKernel>( cached_kernel ) ).first->second;
+}
+
+uint64_t ScatterKernel::GetKey( const Gantry& gantry, const TomographyProperties& tomography_properties ){
+
+	uint64_t key = 0;
+	const auto add_value = [ &key ]( const double value ){
+		key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( value ) ); };
+
+	// detector geometry
+	const vector<DetectorPixel> pixel_array = gantry.pixel_array();
+	const DetectorProperties detector_properties = gantry.detector().properties();
+	add_value( static_cast<double>( pixel_array.size() ) );
+	add_value( detector_properties.row_width );
+	add_value( detector_properties.arc_angle );
+	add_value( detector_properties.detector_focus_distance );
+	add_value( static_cast<double>( detector_properties.has_anti_scattering_structure ) );
+	add_value( detector_properties.max_angle_allowed_by_structure );
+
+	// spectrum
+	const VectorPair spectrum = gantry.tube().GetEnergySpectrumPoints();
+	for( const double energy : spectrum.first ) add_value( energy );
+	for( const double photonflow : spectrum.second ) add_value( photonflow );
+	add_value( gantry.tube().GetEmittedBeamPower() );
+	add_value( static_cast<double>( gantry.tube().number_of_rays_per_pixel() ) );
+
+	// scattering parameter
+	add_value( static_cast<double>( tomography_properties.max_scattering_occurrences ) );
+	add_value( tomography_properties.scatter_propability_correction );
+	add_value( tomography_properties.scattered_ray_absorption_factor );
+	add_value( static_cast<double>( tomography_properties.simulation_quality ) );
+	add_value( static_cast<double>( tomography_properties.random_seed ) );
+
+	return key;
+}
+
+vector<size_t> ScatterKernel::GetSpatialOrder( const vector<DetectorPixel>& pixel_array ){
+
+	// lateral position is the x coordinate in the detector's system
+	vector<size_t> sorted_indices( pixel_array.size() );
+	std::iota( sorted_indices.begin(), sorted_indices.end(), 0 );
+	std::sort( sorted_indices.begin(), sorted_indices.end(),
+						 [ &pixel_array ]( const size_t a, const size_t b ){ return pixel_array.at( a ).origin().X() < pixel_array.at( b ).origin().X(); } );
+
+	vector<size_t> spatial_order( pixel_array.size(), 0 );
+	for( size_t rank = 0; rank < sorted_indices.size(); rank++ )
+		spatial_order.at( sorted_indices.at( rank ) ) = rank;
+
+	return spatial_order;
+}
+
+vector<double> ScatterKernel::GetScatterToPrimaryRatios( const vector<DetectorPixel>& pixel_array, const vector<double>& primary_powers, 
+																												 const double incident_power ) const{
+
+	const size_t number_of_pixel = pixel_array.size();
+	vector<double> scatter_to_primary_ratios( number_of_pixel, 0. );
+
+	if( kernels_.empty() || kernels_.front().size() != 2 * number_of_pixel - 1 || 
+			primary_powers.size() != number_of_pixel || incident_power <= 0. )
+		return scatter_to_primary_ratios;
+
+	const vector<size_t> spatial_order = GetSpatialOrder( pixel_array );
+
+	vector<double> scattered_powers( number_of_pixel, 0. );
+
+	for( size_t source_index = 0; source_index < number_of_pixel; source_index++ ){
+
+		const double transmission = primary_powers.at( source_index ) / incident_power;
+
+		// water equivalent thickness from primary transmission. transmission decreases with thickness
+		size_t upper_index = 1;
+		while( upper_index < transmissions_.size() - 1 && transmissions_.at( upper_index ) > transmission ) upper_index++;
+
+		const double upper_transmission = transmissions_.at( upper_index );
+		const double lower_transmission = transmissions_.at( upper_index - 1 );
+		const double weight = lower_transmission != upper_transmission ?
+			ForceRange( ( lower_transmission - transmission ) / ( lower_transmission - upper_transmission ), 0., 1. ) : 0.;
+
+		const vector<double>& lower_kernel = kernels_.at( upper_index - 1 );
+		const vector<double>& upper_kernel = kernels_.at( upper_index );
+
+		// spread the pixel's scattering to all pixel
+		for( size_t target_index = 0; target_index < number_of_pixel; target_index++ ){
+			const size_t offset_index = spatial_order.at( target_index ) + number_of_pixel - 1 - spatial_order.at( source_index );
+			scattered_powers.at( target_index ) += incident_power *
+				( ( 1. - weight ) * lower_kernel.at( offset_index ) + weight * upper_kernel.at( offset_index ) );
+		}
+	}
+
+	for( size_t pixel_index = 0; pixel_index < number_of_pixel; pixel_index++ ){
+		if( primary_powers.at( pixel_index ) > 0. )
+			scatter_to_primary_ratios.at( pixel_index ) = scattered_powers.at( pixel_index ) / primary_powers.at( pixel_index );
+	}
+
+	return scatter_to_primary_ratios;
+}
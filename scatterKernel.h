@@ -0,0 +1,123 @@
+#pragma once
+/*********************************************************************
+ * @file   scatterKernel.h
+ * @brief  classes for approximated scattering with precomputed kernels
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "generel.h"
+#include "gantry.h"
+#include "detectorPixel.h"
+#include "rayScattering.h"
+#include "tomography.fwd.h"
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for pencil beam scatter kernels
+ * @details kernels are generated with the monte carlo simulation. Pencil beams through both outermost pixel are sent 
+ * through water slabs of different thickness and the scattered power detected in each pixel is stored relative to the incident power.
+ * Primary projections are convolved with the kernels to approximate the scattered power.
+ * The kernels are truncated at the detector's width, so scattering to offsets beyond n - 1 pixel is neglected. 
+ * The slabs are half the detector focus distance wide, which truncates the scattering of rays far off the pencil beam
+*/
+class ScatterKernel{
+
+	public:
+
+	static const string FILE_PREAMBLE;		/*!< string to prepend to file when storing as file*/
+
+	static constexpr double max_thickness_mm = 400.;				/*!< maximum water equivalent thickness*/
+	static constexpr size_t number_of_thicknesses = 17;			/*!< amount of slab thicknesses*/
+	static constexpr size_t number_of_repetitions = 64;			/*!< amount of pencil beam radiations per thickness*/
+	static constexpr double voxel_size_mm = 2.;							/*!< size of slab voxels in beam direction*/
+	static constexpr size_t number_of_lateral_voxels = 64;	/*!< amount of slab voxels perpendicular to beam*/
+
+
+	/*!
+	 * @brief default constructor
+	*/
+	ScatterKernel( void );
+
+	/*!
+	 * @brief generate kernels with monte carlo simulation
+	 * @param gantry gantry in its initial position
+	 * @param tomography_properties properties of tomography. Scattering is enabled during generation
+	 * @param scattering_information information about ray scattering
+	*/
+	ScatterKernel( Gantry gantry, TomographyProperties tomography_properties, const RayScattering& scattering_information );
+
+	/*!
+	 * @brief constructor from serialized data
+	 * @param binary_data reference to vector with binary data
+	 * @param current_byte iterator to start of data in vector
+	*/
+	ScatterKernel( const vector<char>& binary_data, vector<char>::const_iterator& current_byte );
+
+	/*!
+	 * @brief serialize this object
+	 * @param binary_data reference to vector where data will be appended
+	 * @return written bytes
+	*/
+	size_t Serialize( vector<char>& binary_data ) const;
+
+	/*!
+	 * @brief get kernels from memory, program storage or generate and store them
+	 * @param gantry gantry in its initial position
+	 * @param tomography_properties properties of tomography
+	 * @param scattering_information information about ray scattering
+	 * @return kernels for gantry and properties
+	*/
+	static ScatterKernel GetCached( const Gantry& gantry, const TomographyProperties& tomography_properties,
+																	const RayScattering& scattering_information );
+
+	/*!
+	 * @brief get key identifying the parameters the kernels depend on
+	 * @param gantry gantry
+	 * @param tomography_properties properties of tomography
+	 * @return key
+	*/
+	static uint64_t GetKey( const Gantry& gantry, const TomographyProperties& tomography_properties );
+
+	/*!
+	 * @brief get the position of each pixel in a row ordered from one end of the detector to the other
+	 * @param pixel_array pixel of detector
+	 * @return spatial rank of each pixel
+	*/
+	static vector<size_t> GetSpatialOrder( const vector<DetectorPixel>& pixel_array );
+
+	/*!
+	 * @brief get key of kernels
+	 * @return key
+	*/
+	uint64_t key( void ) const{ return key_; };
+
+	/*!
+	 * @brief approximate the ratio of scattered to primary power in each pixel
+	 * @param pixel_array pixel of detector
+	 * @param primary_powers detected primary power of each pixel
+	 * @param incident_power power of the unattenuated rays of one pixel
+	 * @return scatter to primary ratio of each pixel
+	*/
+	vector<double> GetScatterToPrimaryRatios( const vector<DetectorPixel>& pixel_array, const vector<double>& primary_powers, 
+																						const double incident_power ) const;
+
+
+	private:
+
+	uint64_t key_;										/*!< key of the parameters used for generation*/
+	vector<double> thicknesses_;			/*!< water thickness of each kernel in mm*/
+	vector<double> transmissions_;		/*!< primary transmission of each thickness*/
+	vector<vector<double>> kernels_;	/*!< detected scattered power relative to incident power for each pixel offset from -( n - 1 ) to n - 1*/
+
+};
@@ -152,7 +152,7 @@ bool ExportSerialized( const path file_path, const vector<char>& binary_data ){
 	if( file_path.empty() ) return false;
 
 	// storage directory when current_byte does not exist
-	if( !std::filesystem::exists( file_path.parent_path()  )) std::filesystem::create_directory( file_path.parent_path() );
+	if( !file_path.parent_path().empty() && !std::filesystem::exists( file_path.parent_path()  )) std::filesystem::create_directory( file_path.parent_path() );
 
 	return ExportSerialized( file_path.string(), binary_data );
 
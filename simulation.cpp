@@ -10,6 +10,9 @@
   Includes
 *********************************************************************/
 
+#include <atomic>
+#include <thread>
+
 #include "simulation.h"
 #include "serialization.h"
 
@@ -57,4 +60,24 @@ SimulationProperties::SimulationProperties( const vector<char>& binary_data, vec
 
 	quality = number_of_energies_for_scattering / 16 - 1;
 
-}
\ No newline at end of file
+}
+
+
+void SetSimulationQuality( const size_t simulation_quality ){
+	const SimulationProperties new_simulation_properties{ simulation_quality };
+	if( new_simulation_properties.quality != simulation_properties.quality )
+		simulation_properties = new_simulation_properties;
+}
+
+static std::atomic<size_t> number_of_threads{ 0 };
+
+size_t GetNumberOfThreads( void ){
+	const size_t set_number_of_threads = number_of_threads.load();
+	if( set_number_of_threads > 0 ) return set_number_of_threads;
+
+	return ForceToMin1( static_cast<size_t>( std::thread::hardware_concurrency() ) );
+}
+
+void SetNumberOfThreads( const size_t new_number_of_threads ){
+	number_of_threads.store( new_number_of_threads );
+}
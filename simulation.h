@@ -23,6 +23,10 @@ constexpr double min_detetector_arc_angle_rad = 2. * PI * ( 40. / 360. );		/*!<
 constexpr double default_scatter_propability_correction = 1.;												/*!< correction factor for scatter propability*/
 constexpr size_t default_max_radiation_loops = 1;																		/*!< how often can a Ray be scattered*/
 constexpr double default_max_ray_angle_allowed_by_structure = 5. / 360. * 2. * PI;	/*!< default maximum rotation_angle between ray and pixel normal allowed by anti scattering structure*/
+constexpr double russian_roulette_weight = .25;																			/*!< power of scattered ray relative to the mean power below which the ray takes part in russian roulette*/
+constexpr double russian_roulette_survival_weight = .5;															/*!< relative power of rays surviving russian roulette*/
+constexpr double splitting_weight = 4.;																							/*!< power of scattered ray relative to the mean power above which the ray is split*/
+constexpr size_t max_splitting_number = 16;																					/*!< maximum amount of rays a scattered ray is split into*/
 
 constexpr double minimum_energy_in_tube_spectrum = 10000.;		/*!< maximum energy in tube's spectrum*/
 constexpr double maximum_energy_in_tube_spectrum = 210000.;		/*!< minimum energy in tube's spectrum*/
@@ -71,4 +75,24 @@ class SimulationProperties{
 };
 
 
-extern SimulationProperties simulation_properties;		/*!< global instance of simulation properties*/
\ No newline at end of file
+extern SimulationProperties simulation_properties;		/*!< global instance of simulation properties*/
+
+/*!
+ * @brief update the global simulation properties to a quality
+ * @details properties are only written when the quality changes. Concurrent recordings must use the same quality
+ * @param simulation_quality quality of simulation between 0 and 99
+*/
+void SetSimulationQuality( const size_t simulation_quality );
+
+
+/*!
+ * @brief get the amount of threads for parallel computations
+ * @return amount of threads. The hardware's concurrency when not set
+*/
+size_t GetNumberOfThreads( void );
+
+/*!
+ * @brief set the amount of threads for parallel computations
+ * @param number_of_threads amount of threads. Zero for the hardware's concurrency
+*/
+void SetNumberOfThreads( const size_t number_of_threads );
\ No newline at end of file
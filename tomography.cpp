@@ -12,13 +12,23 @@
   Includes
 *********************************************************************/
 
-#include <FL/Fl.H>
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <chrono>
 
 #include "tomography.h"
 #include "coordinateSystemTree.h"
 #include "simulation.h"
 #include "serialization.h"
 #include "projections.h"
+#include "fanBeamProjections.h"
+#include "recordingCheckpoint.h"
+#include "tomographyJob.h"
+#include "scatterKernel.h"
 
 
 /*********************************************************************
@@ -26,7 +36,7 @@
 *********************************************************************/
 
 
-const string TomographyProperties::FILE_PREAMBLE{ "TOMO_PARAMETER_FILE_PREAMBLE_Ver06" };
+const string TomographyProperties::FILE_PREAMBLE{ "TOMO_PARAMETER_FILE_PREAMBLE_Ver12" };
 
 TomographyProperties::TomographyProperties( void ) :
 	scattering_enabled( true ),
@@ -37,13 +47,22 @@ TomographyProperties::TomographyProperties( void ) :
 	mean_energy_of_tube( reference_energy_for_mu_eV ),
 	name( "Unnamed" ),
 	filter_active( false ),
-	simulation_quality( 9 )
+	simulation_quality( 9 ),
+	forced_detection( false ),
+	max_rays_per_iteration( 0 ),
+	random_seed( 0 ),
+	quasi_random_sampling( false ),
+	scatter_kernel_mode( false ),
+	record_split_projections( false )
 
 {}
 
 TomographyProperties::TomographyProperties( const bool scattering_enabled, const size_t max_scattering_occurrences, const double scatter_propability_correction, 
 											const bool use_simple_absorption, const double scattered_ray_absorption_factor,
-											const string name_, const bool filter_active_, const size_t simulation_quality_ ) :
+											const string name_, const bool filter_active_, const size_t simulation_quality_,
+											const bool forced_detection_, const size_t max_rays_per_iteration_,
+											const size_t random_seed_, const bool quasi_random_sampling_,
+											const bool scatter_kernel_mode_, const bool record_split_projections_ ) :
 	scattering_enabled( scattering_enabled ),
 	max_scattering_occurrences( max_scattering_occurrences ),
 	scatter_propability_correction( scatter_propability_correction ),
@@ -52,7 +71,13 @@ TomographyProperties::TomographyProperties( const bool scattering_enabled, const
 	mean_energy_of_tube( reference_energy_for_mu_eV ),
 	name( name_ ),
 	filter_active( filter_active_ ),
-	simulation_quality( simulation_quality_ )
+	simulation_quality( simulation_quality_ ),
+	forced_detection( forced_detection_ ),
+	max_rays_per_iteration( max_rays_per_iteration_ ),
+	random_seed( random_seed_ ),
+	quasi_random_sampling( quasi_random_sampling_ ),
+	scatter_kernel_mode( scatter_kernel_mode_ ),
+	record_split_projections( record_split_projections_ )
 {}
 
 TomographyProperties::TomographyProperties( const vector<char>& binary_data, vector<char>::const_iterator& current_byte ) :
@@ -64,7 +89,13 @@ TomographyProperties::TomographyProperties( const vector<char>& binary_data, vec
 	mean_energy_of_tube( DeSerializeBuildIn<double>( reference_energy_for_mu_eV, binary_data, current_byte ) ),
 	name( DeSerializeBuildIn<string>( "Unnamed", binary_data, current_byte ) ),
 	filter_active( DeSerializeBuildIn<bool>(false, binary_data, current_byte) ),
-	simulation_quality( DeSerializeBuildIn<size_t>(9, binary_data, current_byte) )
+	simulation_quality( DeSerializeBuildIn<size_t>(9, binary_data, current_byte) ),
+	forced_detection( DeSerializeBuildIn<bool>(false, binary_data, current_byte) ),
+	max_rays_per_iteration( DeSerializeBuildIn<size_t>(0, binary_data, current_byte) ),
+	random_seed( DeSerializeBuildIn<size_t>(0, binary_data, current_byte) ),
+	quasi_random_sampling( DeSerializeBuildIn<bool>(false, binary_data, current_byte) ),
+	scatter_kernel_mode( DeSerializeBuildIn<bool>(false, binary_data, current_byte) ),
+	record_split_projections( DeSerializeBuildIn<bool>(false, binary_data, current_byte) )
 
 {
 }
@@ -81,6 +112,12 @@ size_t TomographyProperties::Serialize( vector<char>& binary_data ) const{
 	number_of_bytes += SerializeBuildIn<string>( name, binary_data );
 	number_of_bytes += SerializeBuildIn<bool>( filter_active, binary_data );
 	number_of_bytes += SerializeBuildIn<size_t>( simulation_quality, binary_data );
+	number_of_bytes += SerializeBuildIn<bool>( forced_detection, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( max_rays_per_iteration, binary_data );
+	number_of_bytes += SerializeBuildIn<size_t>( random_seed, binary_data );
+	number_of_bytes += SerializeBuildIn<bool>( quasi_random_sampling, binary_data );
+	number_of_bytes += SerializeBuildIn<bool>( scatter_kernel_mode, binary_data );
+	number_of_bytes += SerializeBuildIn<bool>( record_split_projections, binary_data );
 
 
 	return number_of_bytes;
@@ -88,14 +125,512 @@ size_t TomographyProperties::Serialize( vector<char>& binary_data ) const{
 }
 
 
+std::map<uint64_t, std::shared_ptr<const vector<vector<PixelDetection>>>> Tomography::primary_transport_cache_{};
+vector<uint64_t> Tomography::primary_transport_order_{};
+std::mutex Tomography::primary_transport_mutex_{};
+
 optional<Projections> Tomography::RecordSlice( 
 																		const ProjectionsProperties projection_properties, 
 																		Gantry gantry, const Model& model, 
 																		const double z_position,  
-																		Fl_Progress_Window* progress_window ){
+																		ProgressToken* progress_token,
+																		vector<Projections>* const split_projections,
+																		ProjectionsPreview* const preview ){
+
+	optional<vector<Projections>> slices = RecordSlices( projection_properties, gantry, model, vector<double>{ z_position }, 
+																											 progress_token, split_projections, preview );
+
+	if( !slices.has_value() ) return {};
+
+	return std::move( slices.value().front() );
+}
+
+optional<vector<Projections>> Tomography::RecordVolume( 
+																		const ProjectionsProperties projection_properties, 
+																		Gantry gantry, const Model& model, 
+																		const NumberRange z_range, const double z_step,
+																		ProgressToken* progress_token,
+																		vector<Projections>* const split_projections ){
+
+	// slices from start to end of range
+	const size_t number_of_slices = z_step > 0. ? 
+		static_cast<size_t>( floor( ( z_range.end() - z_range.start() ) / z_step + 1e-9 ) ) + 1 : 1;
+
+	vector<double> z_positions;
+	for( size_t slice_index = 0; slice_index < number_of_slices; slice_index++ )
+		z_positions.push_back( z_range.start() + static_cast<double>( slice_index ) * z_step );
+
+	return RecordSlices( projection_properties, gantry, model, z_positions, progress_token, split_projections );
+}
+
+optional<vector<Projections>> Tomography::RecordHelical( 
+																		const ProjectionsProperties projection_properties, 
+																		Gantry gantry, const Model& model, 
+																		const NumberRange z_range, const double z_step, const double pitch,
+																		ProgressToken* progress_token ){
+
+	// slices from start to end of range
+	const size_t number_of_slices = z_step > 0. ? 
+		static_cast<size_t>( floor( ( z_range.end() - z_range.start() ) / z_step + 1e-9 ) ) + 1 : 1;
+
+	vector<double> z_positions;
+	for( size_t slice_index = 0; slice_index < number_of_slices; slice_index++ )
+		z_positions.push_back( z_range.start() + static_cast<double>( slice_index ) * z_step );
+
+	// update simulation properties
+	SetSimulationQuality( properties_.simulation_quality );
+
+	// table feed per full rotation and per frame
+	const size_t frames_per_rotation = 2 * projection_properties.number_of_projections();
+	const double table_feed = ForceToMin( pitch, 0.01 ) * gantry.detector().properties().row_width;
+	const double z_shift_per_frame = table_feed / static_cast<double>( frames_per_rotation );
+
+	// the helix starts one feed before the first slice so that every slice is enclosed by two rotations
+	const double helix_start = z_positions.front() - table_feed;
+
+	// reset gantry to the start of the helix
+	gantry.ResetGantry();
+	gantry.TranslateInZDirection( helix_start );
+
+	// radon coordinates do not change with the gantry's z-position
+	this->radon_coordinate_system_->CopyPrimitiveFrom( gantry.coordinate_system() );
+
+	// preparation shared by all slices
+	const RecordingPreparation preparation = PrepareRecording( projection_properties, gantry, progress_token );
+	const size_t number_of_frames = projection_properties.number_of_frames_to_fill();
+
+	// helix frame with the same rotation angle as given frame and directly before the slice
+	const auto get_lower_helix_frame = [ & ]( const double z_position, const size_t frame_index ) -> size_t{
+		const double rotations = ( z_position - helix_start ) / table_feed - 
+															static_cast<double>( frame_index ) / static_cast<double>( frames_per_rotation );
+		return static_cast<size_t>( static_cast<long long>( frame_index ) + 
+																static_cast<long long>( floor( rotations ) ) * static_cast<long long>( frames_per_rotation ) );
+	};
+
+	// helix frames needed for interpolation
+	std::map<size_t, vector<bool>> helix_needed_pixel;
+	for( const double z_position : z_positions ){
+		for( size_t frame_index = 0; frame_index < number_of_frames; frame_index++ ){
+			const vector<bool>& frame_needed_pixel = preparation.needed_pixel.at( frame_index );
+			if( std::find( frame_needed_pixel.cbegin(), frame_needed_pixel.cend(), true ) == frame_needed_pixel.cend() ) continue;
+
+			const size_t lower_helix_frame = get_lower_helix_frame( z_position, frame_index );
+			helix_needed_pixel[ lower_helix_frame ] = frame_needed_pixel;
+			helix_needed_pixel[ lower_helix_frame + frames_per_rotation ] = frame_needed_pixel;
+		}
+	}
+
+	const size_t number_of_helix_frames = helix_needed_pixel.empty() ? 0 : helix_needed_pixel.rbegin()->first + 1;
+
+	// frames are indexed along the helix
+	vector<size_t> radiated_frames;
+	vector<vector<bool>> needed_pixel( number_of_helix_frames );
+	for( const auto& [ helix_frame, frame_needed_pixel ] : helix_needed_pixel ){
+		radiated_frames.push_back( helix_frame );
+		needed_pixel.at( helix_frame ) = frame_needed_pixel;
+	}
+	helix_needed_pixel.clear();
+
+	// line integrals of each radiated helix frame
+	std::map<size_t, vector<double>> helix_line_integrals;
+
+	if( progress_token != nullptr ) 
+		progress_token->SetTotal( radiated_frames.size() );
+
+	// frames are radiated independently by a fixed set of workers
+	size_t gantry_frame_index = 0;	// frame of the gantry's current position
+
+	const auto merge_frame = [ & ]( const size_t position, const vector<PixelDetection>& detections ){
+
+		const size_t helix_frame = radiated_frames.at( position );
+		const vector<bool>& frame_needed_pixel = needed_pixel.at( helix_frame );
+
+		if( progress_token != nullptr ) 
+			progress_token->SetLine( 0, "Radiating helix frame " + ConvertToString( position + 1 ) + " of " + 
+																					ConvertToString( radiated_frames.size() ) );
+
+		// approximated scattering in each pixel
+		const vector<double> scatter_to_primary_ratios = GetScatterToPrimaryRatios( preparation, gantry, detections );
+
+		vector<double>& line_integrals = helix_line_integrals[ helix_frame ];
+		line_integrals.assign( preparation.number_of_pixel, 25. );
+
+		for( size_t pixel_index = 0; pixel_index < preparation.number_of_pixel; pixel_index++ ){
+
+			if( !frame_needed_pixel.at( pixel_index ) ) continue;
+
+			const PixelDetection& detection = detections.at( pixel_index );
+			const optional<double> line_integral = properties_.use_simple_absorption ? 
+																							 detection.simple_value : detection.spectral_value;
+
+			// without value no ray was detected and the high value is kept
+			if( line_integral.has_value() )
+				line_integrals.at( pixel_index ) = line_integral.value() - log( 1. + scatter_to_primary_ratios.at( pixel_index ) );
+		}
+
+		if( progress_token != nullptr ) 
+			progress_token->Advance();
+	};
+
+	// helix frames are indexed along the whole helix and select different random numbers without slice index
+	const size_t number_of_merged_frames = 
+		RadiateFrames( gantry, gantry_frame_index, projection_properties.angles_resolution(), z_shift_per_frame, 
+									 radiated_frames, 0, needed_pixel, model, preparation.radiation_properties, preparation.scattering_information,
+									 preparation.radiate_only_needed_pixel, preparation.expected_ray_hits, preparation.start_intensity, false,
+									 progress_token, merge_frame );
+
+	// a stopped helix is incomplete
+	if( number_of_merged_frames < radiated_frames.size() ) 
+		return {};
+
+	// interpolate slices between the two enclosing rotations
+	vector<Projections> slices;
+	for( const double z_position : z_positions ){
+
+		Projections projections{ projection_properties, properties_ };
+
+		for( size_t frame_index = 0; frame_index < number_of_frames; frame_index++ ){
+			
+			const vector<bool>& frame_needed_pixel = preparation.needed_pixel.at( frame_index );
+			const vector<ProjectionsAssignment>& frame_assignments = preparation.projections_assignments.at( frame_index );
+
+			const size_t lower_helix_frame = get_lower_helix_frame( z_position, frame_index );
+			const auto lower_line_integrals = helix_line_integrals.find( lower_helix_frame );
+			const auto upper_line_integrals = helix_line_integrals.find( lower_helix_frame + frames_per_rotation );
+			if( lower_line_integrals == helix_line_integrals.end() || upper_line_integrals == helix_line_integrals.end() ) continue;
+
+			// weight of the upper frame
+			const double lower_z_position = helix_start + static_cast<double>( lower_helix_frame ) * z_shift_per_frame;
+			const double weight = ForceRange( ( z_position - lower_z_position ) / table_feed, 0., 1. );
+
+			for( size_t pixel_index = 0; pixel_index < preparation.number_of_pixel; pixel_index++ ){
+
+				// value would be overwritten in a later frame
+				if( !frame_needed_pixel.at( pixel_index ) ) continue;
+
+				projections.AssignData( frame_assignments.at( pixel_index ), 
+					( 1. - weight ) * lower_line_integrals->second.at( pixel_index ) + weight * upper_line_integrals->second.at( pixel_index ) );
+			}
+		}
+
+		slices.push_back( std::move( projections ) );
+	}
+
+	return slices;
+}
+
+optional<vector<Projections>> Tomography::RecordSlices( 
+																		const ProjectionsProperties projection_properties, 
+																		Gantry gantry, const Model& model, 
+																		const vector<double>& z_positions,
+																		ProgressToken* progress_token,
+																		vector<Projections>* const split_projections,
+																		ProjectionsPreview* const preview ){
+
+	if( z_positions.empty() ) return vector<Projections>{};
+
+	// update simulation properties
+	SetSimulationQuality( properties_.simulation_quality );
+
+	// reset gantry to its initial position
+	gantry.ResetGantry();
+
+	// translate gantry to first slice
+	if( z_positions.front() != 0. )
+		gantry.TranslateInZDirection( z_positions.front() );
+
+	// assign gantry coordinate-system's unit-vectors to radon coordinate system. 
+	// radon coordinates do not change with the slice's position
+	this->radon_coordinate_system_->CopyPrimitiveFrom( gantry.coordinate_system() );
+
+	// preparation shared by all slices
+	const RecordingPreparation preparation = PrepareRecording( projection_properties, gantry, progress_token );
+	
+	const RayScattering& scattering_information = preparation.scattering_information;
+	const vector<vector<ProjectionsAssignment>>& projections_assignments = preparation.projections_assignments;
+	const vector<vector<bool>>& needed_pixel = preparation.needed_pixel;
+	const TomographyProperties& radiation_properties = preparation.radiation_properties;
+	const bool radiate_only_needed_pixel = preparation.radiate_only_needed_pixel;
+	const bool use_scatter_kernel = preparation.use_scatter_kernel;
+	const size_t number_of_pixel = preparation.number_of_pixel;
+	const size_t expected_ray_hits = preparation.expected_ray_hits;
+	const double start_intensity = preparation.start_intensity;
+
+	// without traced scattering the detection results do not depend on the scattering parameters
+	// and can be reused when only those change
+	const size_t number_of_frames = projection_properties.number_of_frames_to_fill();
+	const bool cache_primary_transport = !radiation_properties.scattering_enabled || 
+																			 radiation_properties.max_scattering_occurrences == 0;
+
+	// frames which contribute to the projections
+	vector<size_t> radiated_frames;
+	for( size_t frame_index = 0; frame_index < number_of_frames; frame_index++ ){
+		const vector<bool>& frame_needed_pixel = needed_pixel.at( frame_index );
+		if( std::find( frame_needed_pixel.cbegin(), frame_needed_pixel.cend(), true ) != frame_needed_pixel.cend() )
+			radiated_frames.push_back( frame_index );
+	}
+
+	vector<Projections> slices;
+	vector<Projections> all_split_projections;
+	std::map<uint64_t, vector<vector<PixelDetection>>> recorded_primary_transports;
+	std::map<uint64_t, std::shared_ptr<const vector<vector<PixelDetection>>>> reused_primary_transports;
+	primary_transports_.clear();
+
+	// continue from the last checkpoint of the same recording. Split projections are not part of checkpoints
+	const bool use_checkpoints = !properties_.record_split_projections || split_projections == nullptr;
+	const uint64_t recording_key = use_checkpoints ? GetRecordingKey( projection_properties, gantry, model, z_positions ) : 0;
+	
+	// slice, completed frames and partial projections to resume. No slice is resumed without valid checkpoint
+	size_t resumed_slice_index = z_positions.size();
+	size_t resumed_number_of_frames = 0;
+	Projections resumed_projections;
+
+	if( use_checkpoints ){
+		const optional<RecordingCheckpoint> loaded_checkpoint = RecordingCheckpoint::Load( recording_key );
+		
+		if( loaded_checkpoint.has_value() ){
+			const RecordingCheckpoint& checkpoint = loaded_checkpoint.value();
+			
+			if( checkpoint.slice_index() < z_positions.size() && checkpoint.completed_slices().size() == checkpoint.slice_index() ){
+				slices = checkpoint.completed_slices();
+				resumed_slice_index = checkpoint.slice_index();
+				resumed_number_of_frames = std::min( checkpoint.number_of_completed_frames(), radiated_frames.size() );
+				resumed_projections = checkpoint.projections();
+			}
+		}
+	}
+
+	auto last_checkpoint_time = std::chrono::steady_clock::now();
+
+	if( progress_token != nullptr ){
+		progress_token->SetTotal( z_positions.size() * radiated_frames.size() );
+		progress_token->Advance( slices.size() * radiated_frames.size() + resumed_number_of_frames );
+	}
+
+	// record each slice
+	for( size_t slice_index = slices.size(); slice_index < z_positions.size(); slice_index++ ){
+
+		if( progress_token != nullptr && z_positions.size() > 1 ) 
+			progress_token->SetLine( 1, "Recording slice " + ConvertToString( slice_index + 1 ) + " of " + 
+																					ConvertToString( z_positions.size() ) );
+
+		// move gantry to slice
+		gantry.ResetGantry();
+		if( z_positions.at( slice_index ) != 0. )
+			gantry.TranslateInZDirection( z_positions.at( slice_index ) );
+
+		// create projections 
+		Projections projections{ projection_properties, properties_ };
+
+		// frames already merged into the projections
+		size_t number_of_completed_frames = 0;
+		if( slice_index == resumed_slice_index ){
+			projections = std::move( resumed_projections );
+			number_of_completed_frames = resumed_number_of_frames;
+		}
+
+		// spectral, simple, primary and scatter projections from the same detection results
+		vector<Projections> recorded_split_projections;
+		if( properties_.record_split_projections && split_projections != nullptr ){
+			for( const string split_name : { "spectral", "simple", "primary", "scatter" } ){
+				TomographyProperties split_properties = properties_;
+				split_properties.name += " (" + split_name + ")";
+				if( split_name == "spectral" ) split_properties.use_simple_absorption = false;
+				if( split_name == "simple" ) split_properties.use_simple_absorption = true;
+				recorded_split_projections.emplace_back( projection_properties, split_properties );
+			}
+		}
+
+		// transports of only the needed pixel lack the values scatter kernels need
+		const uint64_t primary_transport_key = cache_primary_transport ? RandomNumberGenerator::CombineIdentifiers( 
+			GetPrimaryTransportKey( projection_properties, gantry, model ), static_cast<uint64_t>( radiate_only_needed_pixel ) ) : 0;
+		std::shared_ptr<const vector<vector<PixelDetection>>> cached_primary_transport;
+		if( cache_primary_transport ){
+			std::lock_guard<std::mutex> lock( primary_transport_mutex_ );
+			const auto cache_entry = primary_transport_cache_.find( primary_transport_key );
+			if( cache_entry != primary_transport_cache_.end() && cache_entry->second->size() == number_of_frames )
+				cached_primary_transport = cache_entry->second;
+		}
+		const bool use_cached_primary_transport = cached_primary_transport != nullptr;
+
+		vector<vector<PixelDetection>> recorded_primary_transport( cache_primary_transport && !use_cached_primary_transport ? number_of_frames : 0 );
+
+		size_t gantry_frame_index = 0;	// frame of the gantry's current position
+
+		if( progress_token != nullptr && number_of_completed_frames > 0 ) 
+			progress_token->SetLine( 1, "Resuming after frame " + ConvertToString( radiated_frames.at( number_of_completed_frames - 1 ) + 1 ) );
+
+		// merge a frame into the projections. Frames are merged in order
+		const auto merge_frame = [ & ]( const size_t radiated_frame_position, const vector<PixelDetection>& detections ){
+
+			const size_t frame_index = radiated_frames.at( radiated_frame_position );
+			const vector<bool>& frame_needed_pixel = needed_pixel.at( frame_index );
+
+			if( progress_token != nullptr ) 
+				progress_token->SetLine( 0, string{ use_cached_primary_transport ? "Reusing frame " : "Radiating frame " } + 
+					ConvertToString( frame_index + 1 ) + " of " + ConvertToString( number_of_frames ) );
+
+			if( cache_primary_transport && !use_cached_primary_transport )
+				recorded_primary_transport.at( frame_index ) = detections;
+
+			// approximated scattering in each pixel
+			const vector<double> scatter_to_primary_ratios = GetScatterToPrimaryRatios( preparation, gantry, detections );
+
+			// assignments in current frame
+			const vector<ProjectionsAssignment>& frame_assignments = 
+				projections_assignments.at( frame_index );
+
+			// iterate all pixel
+			for( size_t pixel_index = 0; pixel_index < number_of_pixel; pixel_index++ ){
+
+				// value would be overwritten in a later frame
+				if( !frame_needed_pixel.at( pixel_index ) ) continue;
+
+				const PixelDetection& detection = detections.at( pixel_index );
+
+				optional<double> line_integral = properties_.use_simple_absorption ? 
+																					detection.simple_value : detection.spectral_value;
+			
+				// if no value no ray was detected by pixel, the line integral would be infinite.
+				// set current_byte to a high value instead
+				if( !line_integral.has_value() ){
+					line_integral = 25.; // is like ray's energy is 1 / 10^11 of its start energy
+				}
+				// detected scattering reduces the line integral
+				else{
+					line_integral = line_integral.value() - log( 1. + scatter_to_primary_ratios.at( pixel_index ) );
+				}
+
+				// assign the data to sinogram
+				projections.AssignData( frame_assignments.at( pixel_index ), line_integral.value() );
+
+				if( recorded_split_projections.empty() ) continue;
+			
+				const double scatter_to_primary_ratio = scatter_to_primary_ratios.at( pixel_index );
+			
+				optional<double> spectral_value = detection.spectral_value;
+				optional<double> simple_value = detection.simple_value;
+				const optional<double> primary_value = detection.primary_value;
+				optional<double> scatter_value = detection.scatter_value;
+			
+				// approximated scattering is not part of the detected rays
+				if( use_scatter_kernel ){
+					if( spectral_value.has_value() ) spectral_value = spectral_value.value() - log( 1. + scatter_to_primary_ratio );
+					if( simple_value.has_value() ) simple_value = simple_value.value() - log( 1. + scatter_to_primary_ratio );
+					if( primary_value.has_value() && scatter_to_primary_ratio > 0. ) 
+						scatter_value = primary_value.value() - log( scatter_to_primary_ratio );
+				}
+
+				const ProjectionsAssignment& assignment = frame_assignments.at( pixel_index );
+				recorded_split_projections.at( 0 ).AssignData( assignment, spectral_value.value_or( 25. ) );
+				recorded_split_projections.at( 1 ).AssignData( assignment, simple_value.value_or( 25. ) );
+				recorded_split_projections.at( 2 ).AssignData( assignment, primary_value.value_or( 25. ) );
+				recorded_split_projections.at( 3 ).AssignData( assignment, scatter_value.value_or( 25. ) );
+			}
+
+			if( progress_token != nullptr ) 
+				progress_token->Advance();
+
+			if( preview != nullptr )
+				preview->Publish( projections );
+
+			// store completed frames periodically
+			if( use_checkpoints && std::chrono::duration<double>( std::chrono::steady_clock::now() - last_checkpoint_time ).count() >= 
+															 RecordingCheckpoint::checkpoint_interval_s ){
+				RecordingCheckpoint{ recording_key, slice_index, radiated_frame_position + 1, slices, projections }.Save();
+				last_checkpoint_time = std::chrono::steady_clock::now();
+			}
+		};
+
+		// frames merged before a stop request
+		size_t number_of_merged_frames = number_of_completed_frames;
+
+		if( use_cached_primary_transport ){
+			for( ; number_of_merged_frames < radiated_frames.size(); number_of_merged_frames++ ){
+				if( progress_token != nullptr && progress_token->stop_requested() ) break;
+				merge_frame( number_of_merged_frames, cached_primary_transport->at( radiated_frames.at( number_of_merged_frames ) ) );
+			}
+		}
+		else{
+			// frames are radiated independently by a fixed set of workers
+			const vector<size_t> remaining_frames( radiated_frames.cbegin() + number_of_completed_frames, radiated_frames.cend() );
+
+			number_of_merged_frames += RadiateFrames( gantry, gantry_frame_index, projection_properties.angles_resolution(), 0., 
+																								remaining_frames, slice_index, needed_pixel, model, radiation_properties, scattering_information,
+																								radiate_only_needed_pixel, expected_ray_hits, start_intensity,
+																								cache_primary_transport || !recorded_split_projections.empty(), progress_token, 
+																								[ & ]( const size_t position, const vector<PixelDetection>& detections ){
+																									merge_frame( number_of_completed_frames + position, detections ); } );
+		}
+
+		// keep the merged frames of a stopped recording
+		if( number_of_merged_frames < radiated_frames.size() ){
+			if( use_checkpoints )
+				RecordingCheckpoint{ recording_key, slice_index, number_of_merged_frames, slices, projections }.Save();
+			return {};
+		}
+
+
+		slices.push_back( std::move( projections ) );
+		all_split_projections.insert( all_split_projections.end(), 
+																	make_move_iterator( recorded_split_projections.begin() ), 
+																	make_move_iterator( recorded_split_projections.end() ) );
+		
+		// transports of resumed slices are incomplete
+		if( use_cached_primary_transport )
+			reused_primary_transports[ primary_transport_key ] = cached_primary_transport;
+		else if( cache_primary_transport && number_of_completed_frames == 0 )
+			recorded_primary_transports[ primary_transport_key ] = std::move( recorded_primary_transport );
+	}
+
+	if( use_checkpoints )
+		RecordingCheckpoint::Remove( recording_key );
+
+	if( split_projections != nullptr )
+		*split_projections = std::move( all_split_projections );
+
+	// store only complete transports. This object holds the recorded and reused transports
+	if( cache_primary_transport ){
+		std::lock_guard<std::mutex> lock( primary_transport_mutex_ );
+		
+		for( auto& [ key, recorded_primary_transport ] : recorded_primary_transports )
+			reused_primary_transports[ key ] = primary_transport_cache_[ key ] = 
+				std::make_shared<const vector<vector<PixelDetection>>>( std::move( recorded_primary_transport ) );
+
+		for( const auto& [ key, primary_transport ] : reused_primary_transports ){
+			primary_transports_.push_back( primary_transport );
+			
+			// a reused transport may have been replaced meanwhile
+			const auto cache_entry = primary_transport_cache_.find( key );
+			if( cache_entry == primary_transport_cache_.end() || cache_entry->second != primary_transport ) continue;
+			primary_transport_order_.erase( std::remove( primary_transport_order_.begin(), primary_transport_order_.end(), key ), primary_transport_order_.end() );
+			primary_transport_order_.push_back( key );
+		}
+
+		// transports not held by any tomography are kept up to a limit
+		const auto is_held = [ & ]( const uint64_t key ){ return primary_transport_cache_.at( key ).use_count() > 1; };
+		size_t number_of_unheld_transports = static_cast<size_t>( 
+			std::count_if( primary_transport_order_.cbegin(), primary_transport_order_.cend(), [ & ]( const uint64_t key ){ return !is_held( key ); } ) );
+
+		for( auto key = primary_transport_order_.begin(); key != primary_transport_order_.end() && number_of_unheld_transports > max_kept_primary_transports; ){
+			if( is_held( *key ) ){ ++key; continue; }
+			primary_transport_cache_.erase( *key );
+			key = primary_transport_order_.erase( key );
+			number_of_unheld_transports--;
+		}
+	}
+
+	return slices;
+}
+
+optional<FanBeamProjections> Tomography::RecordFanBeam( 
+																		const ProjectionsProperties projection_properties, 
+																		Gantry gantry, const Model& model, 
+																		const double z_position, const size_t number_of_frames,
+																		ProgressToken* progress_token ){
 
 	// update simulation properties
-	simulation_properties = SimulationProperties{ properties_.simulation_quality };
+	SetSimulationQuality( properties_.simulation_quality );
 
 	// reset gantry to its initial position
 	gantry.ResetGantry();
@@ -104,76 +639,406 @@ optional<Projections> Tomography::RecordSlice(
 	if( z_position != 0. )
 		gantry.TranslateInZDirection( z_position );
 
-	// assign gantry coordinate-system's unit-vectors to radon coordinate system
+	// radon coordinates do not change with the slice's position
 	this->radon_coordinate_system_->CopyPrimitiveFrom( gantry.coordinate_system() );
 
-	// create projections 
-	Projections projections{ projection_properties, properties_ };
+	// preparation without projections grid
+	const RecordingPreparation preparation = PrepareRecording( projection_properties, gantry, progress_token, false );
+
+	// frames of a full rotation
+	const size_t number_of_recorded_frames = number_of_frames > 0 ? number_of_frames : 2 * projection_properties.number_of_projections();
+
+	// radon coordinates of all pixel in the first frame
+	vector<RadonCoordinates> pixel_coordinates;
+	for( const DetectorPixel& pixel : gantry.pixel_array() )
+		pixel_coordinates.emplace_back( this->radon_coordinate_system_, pixel.NormalLine() );
+
+	FanBeamProjections projections{ projection_properties, properties_, number_of_recorded_frames, pixel_coordinates };
+
+	// every pixel is needed in every frame
+	const vector<vector<bool>> needed_pixel( number_of_recorded_frames, vector<bool>( preparation.number_of_pixel, true ) );
+	
+	vector<size_t> frame_indices;
+	for( size_t frame_index = 0; frame_index < number_of_recorded_frames; frame_index++ ) frame_indices.push_back( frame_index );
+
+	if( progress_token != nullptr ) 
+		progress_token->SetTotal( number_of_recorded_frames );
+
+	size_t gantry_frame_index = 0;	// frame of the gantry's current position
+
+	const size_t number_of_merged_frames = RadiateFrames( gantry, gantry_frame_index, projection_properties.angles_resolution(), 0., 
+		frame_indices, 0, needed_pixel, model, preparation.radiation_properties, preparation.scattering_information,
+		preparation.radiate_only_needed_pixel, preparation.expected_ray_hits, preparation.start_intensity, false, progress_token, 
+		[ & ]( const size_t frame_index, const vector<PixelDetection>& detections ){
+
+			if( progress_token != nullptr ) 
+				progress_token->SetLine( 0, "Radiating frame " + ConvertToString( frame_index + 1 ) + " of " + 
+																		ConvertToString( number_of_recorded_frames ) );
+
+			// approximated scattering in each pixel
+			const vector<double> scatter_to_primary_ratios = GetScatterToPrimaryRatios( preparation, gantry, detections );
 
+			for( size_t pixel_index = 0; pixel_index < preparation.number_of_pixel; pixel_index++ ){
 
-	RayScattering scattering_information{
+				const PixelDetection& detection = detections.at( pixel_index );
+				const optional<double> line_integral = properties_.use_simple_absorption ? 
+																								 detection.simple_value : detection.spectral_value;
+
+				// without value no ray was detected by pixel. the line integral would be infinite
+				projections.AssignData( frame_index, pixel_index, line_integral.has_value() ? 
+					line_integral.value() - log( 1. + scatter_to_primary_ratios.at( pixel_index ) ) : 25. );
+			}
+
+			if( progress_token != nullptr ) 
+				progress_token->Advance();
+		} );
+
+	if( number_of_merged_frames < number_of_recorded_frames ) return {};
+
+	return projections;
+}
+
+optional<FanBeamProjections> Tomography::RecordShortScan( 
+																		const ProjectionsProperties projection_properties, 
+																		Gantry gantry, const Model& model, 
+																		const double z_position, ProgressToken* progress_token ){
+
+	// the frames to fill the projections grid cover pi and the detector's arc angle
+	return RecordFanBeam( projection_properties, gantry, model, z_position, 
+												projection_properties.number_of_frames_to_fill(), progress_token );
+}
+
+
+RecordingPreparation Tomography::PrepareRecording( const ProjectionsProperties& projection_properties, const Gantry& gantry, 
+																																			ProgressToken* progress_token, const bool assign_to_grid ) const{
+
+	RecordingPreparation preparation;
+
+	// tables only depend on quality, energies and detector geometry and are reused between slices
+	preparation.scattering_information = RayScattering::GetCached( 
 		simulation_properties.number_of_scatter_angles,
 		gantry.tube().GetEmittedEnergyRange(),
 		simulation_properties.number_of_energies_for_scattering,
 		gantry.coordinate_system()->GetEz(),
 		atan(gantry.detector().properties().row_width /
-				 gantry.detector().properties().detector_focus_distance / 2) };
+				 gantry.detector().properties().detector_focus_distance / 2) );
+
+	if( assign_to_grid ){
+		// grid of all slices' projections
+		const Projections projections_grid{ projection_properties, properties_ };
 
-	// radiate the model for each frame
-	for( size_t frame_index = 0; 
-							frame_index < projection_properties.number_of_frames_to_fill();			 
-							frame_index++ ){
+		// position of each pixel's value in projections for all frames
+		preparation.projections_assignments = GetProjectionsAssignments( projections_grid, gantry.pixel_array() );
+
+		// pixel whose values end up in the projections
+		preparation.needed_pixel = GetNeededPixel( projections_grid, preparation.projections_assignments );
+	}
+
+	// scattering is approximated with precomputed kernels. Only primary rays are transmitted
+	preparation.use_scatter_kernel = properties_.scatter_kernel_mode && properties_.scattering_enabled &&
+																	 properties_.max_scattering_occurrences > 0;
+
+	preparation.radiation_properties = properties_;
+
+	if( preparation.use_scatter_kernel ){
+		if( progress_token != nullptr ) 
+			progress_token->SetLine( 0, "Generating scatter kernels" );
 		
-		if( progress_window != nullptr ) 
-			progress_window->ChangeLineText( 0, "Radiating frame " + 
-				ConvertToString( frame_index ) + " of " + 
-				ConvertToString( projection_properties.number_of_frames_to_fill() ) );
+		preparation.scatter_kernel = ScatterKernel::GetCached( gantry, properties_, preparation.scattering_information );
+		preparation.radiation_properties.scattering_enabled = false;
+	}
+
+	// without scattering a pixel's value only depends on its own rays. The kernels need all primary values
+	preparation.radiate_only_needed_pixel = !preparation.use_scatter_kernel && ( !properties_.scattering_enabled || 
+																																							properties_.max_scattering_occurrences == 0 );
+
+	// number of pixel and the start intensity of every ray are the same for all frames
+	preparation.number_of_pixel = gantry.pixel_array().size();
+	preparation.expected_ray_hits = gantry.tube().number_of_rays_per_pixel();
+	preparation.start_intensity = gantry.tube().GetEmittedBeamPower() /
+		( static_cast<double>( preparation.number_of_pixel ) * 
+			static_cast<double>( preparation.expected_ray_hits ) );
 
+	return preparation;
+}
+
+vector<double> Tomography::GetScatterToPrimaryRatios( const RecordingPreparation& preparation, const Gantry& gantry, 
+																											const vector<PixelDetection>& detections ) const{
+
+	vector<double> scatter_to_primary_ratios( preparation.number_of_pixel, 0. );
+	if( !preparation.use_scatter_kernel ) return scatter_to_primary_ratios;
+
+	vector<double> primary_powers( preparation.number_of_pixel, 0. );
+	for( size_t pixel_index = 0; pixel_index < preparation.number_of_pixel; pixel_index++ )
+		primary_powers.at( pixel_index ) = detections.at( pixel_index ).primary_power;
 
+	return preparation.scatter_kernel.GetScatterToPrimaryRatios( gantry.pixel_array(), primary_powers, 
+		gantry.tube().GetEmittedBeamPower() / static_cast<double>( preparation.number_of_pixel ) );
+}
+
+size_t Tomography::RadiateFrames( Gantry& gantry, size_t& gantry_frame_index, 
+																 const double angle_per_frame, const double z_shift_per_frame,
+																 const vector<size_t>& frame_indices, const size_t slice_index, const vector<vector<bool>>& needed_pixel,
+																 const Model& model, const TomographyProperties& radiation_properties, 
+																 const RayScattering& scattering_information, const bool radiate_only_needed_pixel,
+																 const size_t expected_ray_hits, const double start_intensity, 
+																 const bool get_all_values, const ProgressToken* const progress_token,
+																 const std::function<void( const size_t position, const vector<PixelDetection>& detections )>& merge_frame ) const{
 
-		// radiate
-		gantry.RadiateModel( model, properties_, scattering_information );
+	if( frame_indices.empty() ) return 0;
 
-		// get the detection result
-		const vector<DetectorPixel> pixel_array = gantry.pixel_array();
+	// workers run ahead of the merged frames by a limited amount of frames to bound the stored detection results
+	const size_t number_of_workers = std::min( GetNumberOfThreads(), frame_indices.size() );
+	const size_t max_frames_ahead = 2 * number_of_workers;
 
-		// iterate all pixel
-		for( const DetectorPixel& pixel : pixel_array ){
+	vector<optional<vector<PixelDetection>>> detections( frame_indices.size() );
 
-			// get coordinates for pixel
-			const RadonCoordinates radon_coordinates{ this->radon_coordinate_system_, 
-																								pixel.NormalLine() };
+	std::mutex frames_mutex;										// guards the gantry, the detection results and the counters below
+	std::condition_variable frames_changed;
+	std::atomic<size_t> next_position{ 0 };			// position in frame_indices of the next frame to radiate
+	size_t number_of_merged_frames = 0;
+	size_t number_of_active_workers = number_of_workers;
+	bool merging_finished = false;
 
-			optional<double> line_integral = 
-				pixel.GetProjectionValue( properties_.use_simple_absorption, 
-					gantry.tube().number_of_rays_per_pixel(), gantry.tube().GetEmittedBeamPower() /
-					( static_cast<double>( pixel_array.size() ) * 
-						static_cast<double>( gantry.tube().number_of_rays_per_pixel() )
-					) );
+	vector<std::thread> workers;
+	for( size_t worker_index = 0; worker_index < number_of_workers; worker_index++ ){
+		workers.emplace_back( [ & ]( void ){
+
+			std::unique_lock<std::mutex> lock( frames_mutex );
 			
-			// if no value no ray was detected by pixel, the line integral would be infinite.
-			// set current_byte to a high value instead
-			if( !line_integral.has_value() ){
-				line_integral = 25.; // is like ray's energy is 1 / 10^11 of its start energy
+			while( true ){
+
+				frames_changed.wait( lock, [ & ]{ return merging_finished || next_position.load() < number_of_merged_frames + max_frames_ahead; } );
+				
+				const size_t position = next_position++;
+				if( merging_finished || position >= frame_indices.size() || 
+						( progress_token != nullptr && progress_token->stop_requested() ) ) break;
+				
+				const size_t frame_index = frame_indices.at( position );
+
+				// the gantry's position is only changed here. frames contain rays and pixel in the model's system
+				const double frame_difference = static_cast<double>( frame_index ) - static_cast<double>( gantry_frame_index );
+				gantry.RotateCounterClockwise( frame_difference * angle_per_frame );
+				if( z_shift_per_frame != 0. )
+					gantry.TranslateInZDirection( frame_difference * z_shift_per_frame );
+				gantry_frame_index = frame_index;
+
+				RadiationFrame frame = gantry.GetRadiationFrame( model, radiate_only_needed_pixel ? needed_pixel.at( frame_index ) : vector<bool>{} );
+				
+				lock.unlock();
+
+				// slices use different random numbers. The first slice uses the streams of a single slice
+				const uint64_t stream_index = slice_index == 0 ? frame_index : RandomNumberGenerator::CombineIdentifiers( slice_index, frame_index );
+				Gantry::RadiateFrame( frame, model, radiation_properties, scattering_information, stream_index, 1, progress_token );
+				vector<PixelDetection> frame_detections = GetPixelDetections( frame.detector.pixel_array(), needed_pixel.at( frame_index ), 
+																																			expected_ray_hits, start_intensity, get_all_values );
+				
+				lock.lock();
+				detections.at( position ) = std::move( frame_detections );
+				frames_changed.notify_all();
 			}
 
-			// get the radon point
-			const RadonPoint radon_point{ radon_coordinates, line_integral.value() };
+			number_of_active_workers--;
+			frames_changed.notify_all();
+		} );
+	}
+
+	// merge frames in order on the calling thread while the workers continue
+	size_t position = 0;
+	for( ; position < frame_indices.size(); position++ ){
+
+		std::unique_lock<std::mutex> lock( frames_mutex );
+		frames_changed.wait( lock, [ & ]{ return detections.at( position ).has_value() || number_of_active_workers == 0; } );
+
+		// frames finished after a stop request are incomplete
+		if( !detections.at( position ).has_value() || ( progress_token != nullptr && progress_token->stop_requested() ) ) break;
+
+		const vector<PixelDetection> frame_detections = std::move( detections.at( position ).value() );
+		detections.at( position ).reset();
+		number_of_merged_frames = position + 1;
+		
+		lock.unlock();
+		frames_changed.notify_all();
+
+		merge_frame( position, frame_detections );
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( frames_mutex );
+		merging_finished = true;
+	}
+	frames_changed.notify_all();
+
+	for( std::thread& worker : workers ) worker.join();
+
+	return position;
+}
+
+uint64_t Tomography::GetRecordingKey( const ProjectionsProperties& projections_properties, const Gantry& gantry, const Model& model, 
+																		 const vector<double>& z_positions ) const{
+
+	// geometry, model and primary transport
+	uint64_t key = GetPrimaryTransportKey( projections_properties, gantry, model );
+	
+	// all tomography properties
+	vector<char> properties_data;
+	properties_.Serialize( properties_data );
+	for( const char byte : properties_data ) key = RandomNumberGenerator::CombineIdentifiers( key, static_cast<unsigned char>( byte ) );
+
+	// slices
+	for( const double z_position : z_positions ) 
+		key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( z_position ) );
+
+	return key;
+}
+
+uint64_t Tomography::GetPrimaryTransportKey( const ProjectionsProperties& projections_properties, const Gantry& gantry, const Model& model ) const{
+
+	uint64_t key = 0;
+	const auto add_value = [ &key ]( const double value ){
+		key = RandomNumberGenerator::CombineIdentifiers( key, std::bit_cast<uint64_t>( value ) ); };
+	const auto add_binary_data = [ &key ]( const vector<char>& binary_data ){
+		for( const char byte : binary_data ) key = RandomNumberGenerator::CombineIdentifiers( key, static_cast<unsigned char>( byte ) ); };
+	const auto add_system = [ &add_value ]( const CoordinateSystem* const coordinate_system ){
+		const PrimitiveVector3 origin = Point3D{ Tuple3D{ 0, 0, 0 }, coordinate_system }.GetComponents( GetGlobalSystem() );
+		const PrimitiveVector3 ex = coordinate_system->GetEx().GetComponents( GetGlobalSystem() );
+		const PrimitiveVector3 ey = coordinate_system->GetEy().GetComponents( GetGlobalSystem() );
+		for( const double value : { origin.x, origin.y, origin.z, ex.x, ex.y, ex.z, ey.x, ey.y, ey.z } ) add_value( value ); };
+
+	// model data and position
+	key = RandomNumberGenerator::CombineIdentifiers( key, model.GetFingerprint() );
+	add_system( model.coordinate_system() );
+
+	// gantry position, tube and detector
+	add_system( gantry.coordinate_system() );
+
+	vector<char> tube_data;
+	gantry.tube().properties().Serialize( tube_data );
+	add_binary_data( tube_data );
+	add_value( static_cast<double>( gantry.tube().number_of_rays_per_pixel() ) );
+
+	const DetectorProperties detector_properties = gantry.detector().properties();
+	add_value( static_cast<double>( gantry.pixel_array().size() ) );
+	add_value( detector_properties.row_width );
+	add_value( detector_properties.arc_angle );
+	add_value( detector_properties.detector_focus_distance );
+	add_value( static_cast<double>( detector_properties.has_anti_scattering_structure ) );
+	add_value( detector_properties.max_angle_allowed_by_structure );
+
+	vector<char> projections_data;
+	projections_properties.Serialize( projections_data );
+	add_binary_data( projections_data );
+
+	// properties affecting the primary rays
+	add_value( static_cast<double>( properties_.simulation_quality ) );
+	add_value( static_cast<double>( properties_.random_seed ) );
+	add_value( static_cast<double>( properties_.quasi_random_sampling ) );
+	add_value( static_cast<double>( properties_.use_simple_absorption ) );
+
+	return key;
+}
+
+vector<PixelDetection> Tomography::GetPixelDetections( const vector<DetectorPixel>& pixel_array, const vector<bool>& needed_pixel, 
+																											 const size_t expected_ray_hits, const double start_intensity, const bool get_all_values ) const{
+
+	vector<PixelDetection> detections( pixel_array.size() );
 
-			// assign the data to sinogram
-			projections.AssignData( radon_point );
+	for( size_t pixel_index = 0; pixel_index < pixel_array.size(); pixel_index++ ){
+
+		const DetectorPixel& pixel = pixel_array.at( pixel_index );
+		PixelDetection& detection = detections.at( pixel_index );
+
+		// the kernels need the primary power of all pixel
+		detection.primary_power = pixel.GetDetectedPower( false );
+
+		if( !needed_pixel.at( pixel_index ) ) continue;
+
+		if( get_all_values || !properties_.use_simple_absorption )
+			detection.spectral_value = pixel.GetProjectionValue( false, expected_ray_hits, start_intensity );
+		
+		if( get_all_values || properties_.use_simple_absorption )
+			detection.simple_value = pixel.GetProjectionValue( true, expected_ray_hits, start_intensity );
+		
+		if( !get_all_values ) continue;
+
+		detection.primary_value = pixel.GetProjectionValue( properties_.use_simple_absorption, expected_ray_hits, 
+																												start_intensity, DetectedRays::Primary );
+		detection.scatter_value = pixel.GetProjectionValue( properties_.use_simple_absorption, expected_ray_hits, 
+																												start_intensity, DetectedRays::Scattered );
+	}
+
+	return detections;
+}
+
+vector<vector<ProjectionsAssignment>> Tomography::GetProjectionsAssignments( 
+																				const Projections& projections, 
+																				const vector<DetectorPixel>& pixel_array ) const{
+
+	const size_t number_of_frames = projections.properties().number_of_frames_to_fill();
+	const double angle_resolution = projections.properties().angles_resolution();
+
+	// radon coordinates of all pixel in the gantry's initial position
+	vector<RadonCoordinates> initial_coordinates;
+	initial_coordinates.reserve( pixel_array.size() );
+
+	for( const DetectorPixel& pixel : pixel_array ){
+		initial_coordinates.emplace_back( this->radon_coordinate_system_, pixel.NormalLine() );
+	}
+
+	vector<vector<ProjectionsAssignment>> assignments( number_of_frames, 
+		vector<ProjectionsAssignment>( pixel_array.size() ) );
+
+	for( size_t frame_index = 0; frame_index < number_of_frames; frame_index++ ){
+
+		const double rotation_angle = static_cast<double>( frame_index ) * angle_resolution;
+
+		for( size_t pixel_index = 0; pixel_index < pixel_array.size(); pixel_index++ ){
+
+			RadonCoordinates radon_coordinates = initial_coordinates.at( pixel_index );
+			radon_coordinates.theta += rotation_angle;
+
+			// the line with angle theta + pi is the line with angle theta and negative distance
+			while( radon_coordinates.theta >= PI ){
+				radon_coordinates.theta -= PI;
+				radon_coordinates.distance = -radon_coordinates.distance;
+			}
+
+			assignments.at( frame_index ).at( pixel_index ) = 
+				projections.GetAssignment( radon_coordinates );
 		}
+	}
+
+	return assignments;
+}
+
+vector<vector<bool>> Tomography::GetNeededPixel( 
+													const Projections& projections, 
+													const vector<vector<ProjectionsAssignment>>& projections_assignments ){
+
+	vector<vector<bool>> needed_pixel;
+	needed_pixel.reserve( projections_assignments.size() );
+
+	// frame and pixel index of the last assignment to each grid point
+	vector<vector<optional<pair<size_t, size_t>>>> last_assignments( projections.size().c, 
+		vector<optional<pair<size_t, size_t>>>( projections.size().r ) );
+
+	for( size_t frame_index = 0; frame_index < projections_assignments.size(); frame_index++ ){
 		
-		// rotate gantry
-		gantry.RotateCounterClockwise( projection_properties.angles_resolution() );
+		const vector<ProjectionsAssignment>& frame_assignments = projections_assignments.at( frame_index );
+		needed_pixel.emplace_back( frame_assignments.size(), false );
 
-		Fl::check();
+		for( size_t pixel_index = 0; pixel_index < frame_assignments.size(); pixel_index++ ){
+			const GridIndex index = frame_assignments.at( pixel_index ).index;
+			last_assignments.at( index.c ).at( index.r ) = pair<size_t, size_t>{ frame_index, pixel_index };
+		}
+	}
 
-		if( progress_window != nullptr ){
-			if( !progress_window->visible() )
-				return {};
+	for( const auto& column : last_assignments ){
+		for( const auto& last_assignment : column ){
+			if( last_assignment.has_value() )
+				needed_pixel.at( last_assignment.value().first ).at( last_assignment.value().second ) = true;
 		}
 	}
 
-	return projections;
+	return needed_pixel;
 }
\ No newline at end of file
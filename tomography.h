@@ -13,12 +13,20 @@
 *********************************************************************/
 
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+
 #include "generel.h"
 #include "gantry.h"
 #include "model.h"
 #include "projections.fwd.h"
+#include "fanBeamProjections.fwd.h"
+#include "tomographyJob.fwd.h"
+#include "scatterKernel.h"
 
-#include "fl_ProgressWindow.h"
+#include "progressToken.h"
 
 
 /*********************************************************************
@@ -49,10 +57,19 @@ class TomographyProperties{
 	 * @param name name for identification
 	 * @param filter_active flag for active tube filter
 	 * @param simulation_quality simulation quality
+	 * @param forced_detection add the expected contribution of each scattering to all pixel instead of tracing scattered rays
+	 * @param max_rays_per_iteration maximum amount of scattered rays per iteration. Zero disables russian roulette and splitting
+	 * @param random_seed seed for the random numbers of the simulation
+	 * @param quasi_random_sampling use scrambled halton sequences for the primary rays instead of pseudo random numbers
+	 * @param scatter_kernel_mode approximate scattering with precomputed kernels instead of tracing scattered rays
+	 * @param record_split_projections additionally record spectral, simple, primary and scatter projections
 	*/
 	TomographyProperties( const bool scattering_enabled, const size_t max_scattering_occurrences, const double scatter_propability_correction, 
 						  const bool use_simple_absorption, const double scattered_ray_absorption_factor,
-						  const string name = "Unnamed", const bool filter_active = false, const size_t simulation_quality = 9 );
+						  const string name = "Unnamed", const bool filter_active = false, const size_t simulation_quality = 9,
+						  const bool forced_detection = false, const size_t max_rays_per_iteration = 0,
+						  const size_t random_seed = 0, const bool quasi_random_sampling = false,
+							  const bool scatter_kernel_mode = false, const bool record_split_projections = false );
 	
 	/*!
 	 * @brief constructor from serialized data
@@ -80,6 +97,54 @@ class TomographyProperties{
 	string name;														/*!< name for identifiaction*/
 	bool filter_active;											/*!< flag for filter*/
 	size_t simulation_quality;							/*!< stored simulation quality*/
+	bool forced_detection;									/*!< flag for forced detection. The expected contribution of each scattering is added to all pixel. Only single scattering is simulated*/
+	size_t max_rays_per_iteration;					/*!< maximum amount of scattered rays per iteration. Enables russian roulette and splitting when not zero*/
+	size_t random_seed;											/*!< seed for random numbers. Same seed and parameters give identical results*/
+	bool quasi_random_sampling;							/*!< flag for quasi random numbers. Each primary ray is a point of a scrambled halton sequence*/
+	bool scatter_kernel_mode;								/*!< flag for approximated scattering. Primary projections are convolved with precomputed scatter kernels*/
+	bool record_split_projections;					/*!< flag for recording spectral, simple, primary and scatter projections in the same run*/
+};
+
+
+/*!
+ * @brief class for the detection result of a single pixel
+*/
+class PixelDetection{
+
+	public:
+
+	/*!
+	 * @brief default constructor
+	*/
+	PixelDetection( void ) :
+		spectral_value(), simple_value(), primary_value(), scatter_value(), primary_power( 0. ){};
+
+
+	optional<double> spectral_value;	/*!< line integral of all rays with energy dependent attenuation*/
+	optional<double> simple_value;		/*!< line integral of all rays with simple attenuation*/
+	optional<double> primary_value;		/*!< line integral of primary rays*/
+	optional<double> scatter_value;		/*!< line integral of scattered rays*/
+	double primary_power;							/*!< detected power of primary rays*/
+};
+
+
+/*!
+ * @brief class for the data prepared once for all slices of a recording
+*/
+class RecordingPreparation{
+
+	public:
+
+	RayScattering scattering_information;													/*!< information about ray scattering*/
+	vector<vector<ProjectionsAssignment>> projections_assignments;	/*!< position of each pixel's value in projections for all frames*/
+	vector<vector<bool>> needed_pixel;														/*!< pixel whose values end up in the projections for all frames*/
+	bool use_scatter_kernel = false;															/*!< flag for approximated scattering*/
+	ScatterKernel scatter_kernel;																	/*!< scatter kernels when scattering is approximated*/
+	TomographyProperties radiation_properties;										/*!< properties used for the transmission*/
+	bool radiate_only_needed_pixel = false;												/*!< flag to emit only rays of needed pixel*/
+	size_t number_of_pixel = 0;																		/*!< amount of pixel*/
+	size_t expected_ray_hits = 0;																	/*!< expected amount of rays hitting a pixel*/
+	double start_intensity = 0.;																	/*!< start intensity of each ray*/
 };
 
 
@@ -93,9 +158,10 @@ class Tomography{
 	/*!
 	 * @brief constructor
 	 * @param properties properties of computed tomography
+	 * @param radon_coordinate_system coordinate system to use as reference for radon coordinates. Recordings running at the same time need their own
 	*/
-	Tomography( const TomographyProperties properties ) :
-		properties_( properties ), radon_coordinate_system_( GetDummySystem() )
+	Tomography( const TomographyProperties properties, CoordinateSystem* const radon_coordinate_system = GetDummySystem() ) :
+		properties_( properties ), radon_coordinate_system_( radon_coordinate_system )
 	{};
 
 	/*!
@@ -111,15 +177,225 @@ class Tomography{
 	 * @param gantry gantry of ct-device
 	 * @param model model to slice
 	 * @param z_position z-positon of slice
-	 * @param progress_window window to show progress
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @param split_projections when given and enabled in properties spectral, simple, primary and scatter projections are written to it
+	 * @param preview when given the partially recorded projections are published to it
 	 * @return the projections when process was not terminated
 	*/
-	optional<Projections> RecordSlice( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, const double z_position, Fl_Progress_Window* progress_window = nullptr );
+	optional<Projections> RecordSlice( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, const double z_position, ProgressToken* progress_token = nullptr,
+																		 vector<Projections>* const split_projections = nullptr, ProjectionsPreview* const preview = nullptr );
+
+	/*!
+	 * @brief record a volume as a stack of slices
+	 * @details tables, projection assignments and scatter kernels are prepared once for all slices
+	 * @param projections_properties properties of radon transformed
+	 * @param gantry gantry of ct-device
+	 * @param model model to slice
+	 * @param z_range z-positions of first and last slice
+	 * @param z_step distance between two slices
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @param split_projections when given and enabled in properties spectral, simple, primary and scatter projections of each slice are written to it
+	 * @return the projections of each slice when process was not terminated
+	*/
+	optional<vector<Projections>> RecordVolume( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, 
+																							const NumberRange z_range, const double z_step, ProgressToken* progress_token = nullptr,
+																							vector<Projections>* const split_projections = nullptr );
+
+	/*!
+	 * @brief record a volume with a helical scan
+	 * @details the gantry translates in z-direction while rotating. The projections of each slice are interpolated linearly
+	 * between the two frames with the same rotation angle that enclose the slice. The helix starts one table feed 
+	 * before the first slice and ends one table feed after the last slice
+	 * @param projections_properties properties of radon transformed
+	 * @param gantry gantry of ct-device
+	 * @param model model to slice
+	 * @param z_range z-positions of first and last slice
+	 * @param z_step distance between two slices
+	 * @param pitch table feed per full rotation relative to the detector's row width
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @return the projections of each slice when process was not terminated
+	*/
+	optional<vector<Projections>> RecordHelical( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, 
+																							 const NumberRange z_range, const double z_step, const double pitch,
+																							 ProgressToken* progress_token = nullptr );
+
+	/*!
+	 * @brief get the cached primary transports recorded or reused by the last recording
+	 * @details only recordings without traced scattering cache their transport. This includes the scatter kernel mode, where 
+	 * changed scattering parameters only change the kernels. A transport is not removed from the cache while it is held. 
+	 * Later recordings sharing it can rely on reusing it
+	 * @return transports of the last recording. Empty when its transport was not cached
+	*/
+	vector<std::shared_ptr<const vector<vector<PixelDetection>>>> primary_transports( void ) const{ return primary_transports_; };
+
+	/*!
+	 * @brief record a slice as fan-beam projections
+	 * @details every pixel is recorded in every frame. The frames are not tied to filling a parallel projections grid
+	 * @param projections_properties properties of radon transformed. The gantry rotates by the angle resolution between two frames
+	 * @param gantry gantry of ct-device
+	 * @param model model to slice
+	 * @param z_position z-positon of slice
+	 * @param number_of_frames amount of frames to record. A full rotation when zero
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @return the fan-beam projections when process was not terminated
+	*/
+	optional<FanBeamProjections> RecordFanBeam( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, 
+																							const double z_position, const size_t number_of_frames = 0, 
+																							ProgressToken* progress_token = nullptr );
+
+	/*!
+	 * @brief record a slice as fan-beam projections of half a rotation plus the fan angle
+	 * @details the reconstruction applies parker weights to the samples recorded twice. The frames are the frames to fill 
+	 * the parallel projections grid, about half the frames of a full rotation
+	 * @param projections_properties properties of radon transformed
+	 * @param gantry gantry of ct-device
+	 * @param model model to slice
+	 * @param z_position z-positon of slice
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @return the fan-beam projections when process was not terminated
+	*/
+	optional<FanBeamProjections> RecordShortScan( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, 
+																								const double z_position, ProgressToken* progress_token = nullptr );
 
 	
 	private:
 
 	TomographyProperties properties_;						/*!< properties used for tomography*/
 	CoordinateSystem* radon_coordinate_system_;	/*!< coordinate system to use as reference for radon coordinates calculation*/
+
+	vector<std::shared_ptr<const vector<vector<PixelDetection>>>> primary_transports_;	/*!< cached transports of the last recording. They stay cached while held*/
+
+	static constexpr size_t max_kept_primary_transports = 4;	/*!< amount of transports kept from earlier recordings which are not held by any tomography*/
+
+	static std::map<uint64_t, std::shared_ptr<const vector<vector<PixelDetection>>>> primary_transport_cache_;	/*!< detection results of each frame and pixel of the recently recorded slices without traced scattering*/
+	static vector<uint64_t> primary_transport_order_;		/*!< keys of cached transports from oldest to newest*/
+	static std::mutex primary_transport_mutex_;					/*!< mutex for cached transports. Recordings may run concurrently*/
+
+
+	/*!
+	 * @brief record slices at given z-positions
+	 * @param projections_properties properties of radon transformed
+	 * @param gantry gantry of ct-device
+	 * @param model model to slice
+	 * @param z_positions z-positions of the slices
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @param split_projections when given and enabled in properties spectral, simple, primary and scatter projections of each slice are written to it
+	 * @param preview when given the partially recorded projections of the current slice are published to it
+	 * @return the projections of each slice when process was not terminated
+	*/
+	optional<vector<Projections>> RecordSlices( const ProjectionsProperties projections_properties, Gantry gantry, const Model& model, 
+																							const vector<double>& z_positions, ProgressToken* progress_token,
+																							vector<Projections>* const split_projections, ProjectionsPreview* const preview = nullptr );
+
+
+	/*!
+	 * @brief get the position of each pixel's value in the projections for every frame
+	 * @details the detector is fixed inside the gantry and the gantry rotates by the angle resolution between two frames.
+	 * A pixel's radon angle therefore increases linearly with the frame index and its distance only changes its sign
+	 * @param projections projections to get the assignments for
+	 * @param pixel_array detector pixel in the gantry's initial position
+	 * @return assignments for each frame and each pixel
+	*/
+	vector<vector<ProjectionsAssignment>> GetProjectionsAssignments( const Projections& projections, 
+																																	 const vector<DetectorPixel>& pixel_array ) const;
+
+	/*!
+	 * @brief get the key identifying a primary transport
+	 * @details the transport depends on the model, the gantry's position, the tube, the detector and the random numbers.
+	 * Scattering parameters are not part of the key, because only transports without traced scattering are cached
+	 * @param projections_properties properties of projections
+	 * @param gantry gantry in its initial position
+	 * @param model model to radiate
+	 * @return key
+	*/
+	uint64_t GetPrimaryTransportKey( const ProjectionsProperties& projections_properties, const Gantry& gantry, const Model& model ) const;
+
+	/*!
+	 * @brief get the key identifying a recording
+	 * @details includes the primary transport key, all tomography properties and the slice positions
+	 * @param projections_properties properties of projections
+	 * @param gantry gantry at the first slice
+	 * @param model model to radiate
+	 * @param z_positions z-positions of the slices
+	 * @return key
+	*/
+	uint64_t GetRecordingKey( const ProjectionsProperties& projections_properties, const Gantry& gantry, const Model& model, 
+														const vector<double>& z_positions ) const;
+
+	/*!
+	 * @brief prepare the data shared by all slices of a recording
+	 * @details the radon coordinate system must be set before
+	 * @param projection_properties properties of projections
+	 * @param gantry gantry in its initial rotation
+	 * @param progress_token token to report progress and to stop. Can be null
+	 * @param assign_to_grid get the assignments of pixel to the projections grid and the needed pixel
+	 * @return prepared data
+	*/
+	RecordingPreparation PrepareRecording( const ProjectionsProperties& projection_properties, const Gantry& gantry, 
+																				 ProgressToken* progress_token, const bool assign_to_grid = true ) const;
+
+	/*!
+	 * @brief get the approximated scatter to primary ratio of each pixel
+	 * @param preparation prepared data of the recording
+	 * @param gantry gantry of the recording
+	 * @param detections detection results of a frame
+	 * @return scatter to primary ratios. Zero when scattering is not approximated
+	*/
+	vector<double> GetScatterToPrimaryRatios( const RecordingPreparation& preparation, const Gantry& gantry, 
+																						const vector<PixelDetection>& detections ) const;
+
+	/*!
+	 * @brief radiate frames in parallel
+	 * @details a fixed set of workers takes the frames in order through a shared index. The gantry is moved to a frame's position 
+	 * under a lock before the frame is transmitted. Finished frames are merged in order on the calling thread while the workers continue
+	 * @param gantry gantry at the position of the frame with index gantry_frame_index. Is at the position of the last frame afterwards
+	 * @param gantry_frame_index index of the gantry's current frame. Is updated
+	 * @param angle_per_frame rotation of the gantry between two frames
+	 * @param z_shift_per_frame translation of the gantry in z-direction between two frames
+	 * @param frame_indices indices of the frames to radiate
+	 * @param slice_index index of the recorded slice. Selects the random number streams together with the frame index
+	 * @param needed_pixel flags for each frame and pixel whose line integrals are needed
+	 * @param model model to radiate
+	 * @param radiation_properties properties used for the transmission
+	 * @param scattering_information information about ray scattering
+	 * @param radiate_only_needed_pixel when true only the needed pixel's rays are emitted
+	 * @param expected_ray_hits the expected amount of rays to hit a pixel
+	 * @param start_intensity start intensities of rays
+	 * @param get_all_values when false only the line integral selected by the properties is calculated
+	 * @param progress_token token which stops the transmission. Frames finished after stop was requested are not merged
+	 * @param merge_frame called on the calling thread with the position in frame_indices and the detection results of each frame in order. 
+	 * Must not depend on the gantry's position
+	 * @return amount of merged frames. Less than the amount of frames when stop was requested
+	*/
+	size_t RadiateFrames( Gantry& gantry, size_t& gantry_frame_index, 
+												const double angle_per_frame, const double z_shift_per_frame,
+												const vector<size_t>& frame_indices, const size_t slice_index, const vector<vector<bool>>& needed_pixel,
+												const Model& model, const TomographyProperties& radiation_properties, 
+												const RayScattering& scattering_information, const bool radiate_only_needed_pixel,
+												const size_t expected_ray_hits, const double start_intensity, 
+												const bool get_all_values, const ProgressToken* const progress_token,
+												const std::function<void( const size_t position, const vector<PixelDetection>& detections )>& merge_frame ) const;
+
+	/*!
+	 * @brief get the detection results of all pixel
+	 * @param pixel_array pixel with detected rays
+	 * @param needed_pixel flag for each pixel whose line integrals are needed
+	 * @param expected_ray_hits the expected amount of rays to hit a pixel
+	 * @param start_intensity start intensities of rays
+	 * @param get_all_values when false only the line integral selected by the properties is calculated
+	 * @return detection result of each pixel
+	*/
+	vector<PixelDetection> GetPixelDetections( const vector<DetectorPixel>& pixel_array, const vector<bool>& needed_pixel, 
+																						 const size_t expected_ray_hits, const double start_intensity, const bool get_all_values ) const;
+
+	/*!
+	 * @brief get the pixel whose value is stored in the projections
+	 * @details a grid point can be hit by multiple pixel in different frames. Only the last assignment persists
+	 * @param projections projections the assignments belong to
+	 * @param projections_assignments assignments for each frame and each pixel
+	 * @return flag for each frame and pixel. True when the pixel's value is needed
+	*/
+	static vector<vector<bool>> GetNeededPixel( const Projections& projections, 
+																							const vector<vector<ProjectionsAssignment>>& projections_assignments );
 };
 
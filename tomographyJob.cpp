@@ -0,0 +1,83 @@
+/*********************************************************************
+ * @file   tomographyJob.cpp
+ * @brief  implementations
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include "tomographyJob.h"
+
+
+
+/*********************************************************************
+  Implementations
+*********************************************************************/
+
+
+/*
+	ProjectionsPreview implementation
+*/
+
+ProjectionsPreview::ProjectionsPreview( void ) :
+	projections_{},
+	revision_( 0 ),
+	last_publication_{}
+{}
+
+void ProjectionsPreview::Publish( const Projections& projections ){
+
+	// only the recording publishes. no lock needed for the time
+	const auto now = std::chrono::steady_clock::now();
+	if( revision_.load() > 0 && std::chrono::duration<double>( now - last_publication_ ).count() < publish_interval_s ) 
+		return;
+
+	last_publication_ = now;
+
+	{
+		std::lock_guard<mutex> lock{ projections_mutex_ };
+		projections_ = projections;
+	}
+
+	++revision_;
+}
+
+Projections ProjectionsPreview::projections( void ) const{
+	std::lock_guard<mutex> lock{ projections_mutex_ };
+	return projections_;
+}
+
+
+/*
+	TomographyJob implementation
+*/
+
+TomographyJob::TomographyJob( const TomographyProperties tomography_properties, const ProjectionsProperties projections_properties, 
+															const Gantry& gantry, const Model& model, const double z_position ) :
+	properties_( tomography_properties ),
+	projections_properties_( projections_properties ),
+	gantry_( gantry ),
+	model_( model ),
+	z_position_( z_position ),
+	tomography_{ tomography_properties },
+	progress_token_{},
+	preview_{},
+	projections_{},
+	split_projections_{},
+	finished_{ false },
+	worker_{ [ this ]( void ){
+		projections_ = tomography_.RecordSlice( projections_properties_, gantry_, model_, z_position_, 
+																						&progress_token_, &split_projections_, &preview_ );
+		finished_.store( true );
+	} }
+{}
+
+TomographyJob::~TomographyJob( void ){
+	progress_token_.RequestStop();
+	if( worker_.joinable() ) worker_.join();
+}
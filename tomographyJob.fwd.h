@@ -0,0 +1,4 @@
+#pragma once
+
+class ProjectionsPreview;
+class TomographyJob;
@@ -0,0 +1,184 @@
+#pragma once
+/*********************************************************************
+ * @file   tomographyJob.h
+ * @brief  classes to record slices in the background
+ *
+ * @author Jan Wolzenburg
+ * @date   October 2026
+ *********************************************************************/
+
+
+ /*********************************************************************
+  Includes
+*********************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "generel.h"
+#include "tomography.h"
+#include "projections.h"
+#include "progressToken.h"
+
+
+
+/*********************************************************************
+   Definitions
+*********************************************************************/
+
+/*!
+ * @brief class for the partially recorded projections of a running recording
+ * @details the recording publishes its projections after merged frames. Observers copy the latest projections 
+ * when the revision changed
+*/
+class ProjectionsPreview{
+
+	public:
+
+	static constexpr double publish_interval_s = .1;	/*!< minimum time between two publications*/
+
+
+	/*!
+	 * @brief default constructor
+	*/
+	ProjectionsPreview( void );
+
+	/*!
+	 * @brief deleted
+	*/
+	ProjectionsPreview( const ProjectionsPreview& ) = delete;
+
+	/*!
+	 * @brief deleted
+	*/
+	ProjectionsPreview& operator=( const ProjectionsPreview& ) = delete;
+
+	/*!
+	 * @brief publish the current projections
+	 * @details skipped when the last publication is more recent than the publish interval
+	 * @param projections projections to publish
+	*/
+	void Publish( const Projections& projections );
+
+	/*!
+	 * @brief get the latest published projections
+	 * @return copy of projections
+	*/
+	Projections projections( void ) const;
+
+	/*!
+	 * @brief get the revision which changes with every publication
+	 * @return revision. Zero when nothing was published
+	*/
+	size_t revision( void ) const{ return revision_.load(); };
+
+
+	private:
+
+	mutable mutex projections_mutex_;												/*!< mutual exclusion for projections*/
+	Projections projections_;																/*!< latest projections*/
+	std::atomic<size_t> revision_;													/*!< counter for publications*/
+	std::chrono::steady_clock::time_point last_publication_;	/*!< time of last publication*/
+
+};
+
+
+/*!
+ * @brief class for a slice recording running on its own thread
+ * @details the recording starts with construction. The gantry and the model must not change while the job runs 
+ * because the copied gantry shares its coordinate system and the model is referenced
+*/
+class TomographyJob{
+
+	public:
+
+	/*!
+	 * @brief constructor
+	 * @param tomography_properties properties of tomography
+	 * @param projections_properties properties of projections
+	 * @param gantry gantry of ct-device
+	 * @param model model to slice. Must outlive the job
+	 * @param z_position z-position of slice
+	*/
+	TomographyJob( const TomographyProperties tomography_properties, const ProjectionsProperties projections_properties, 
+								 const Gantry& gantry, const Model& model, const double z_position = 0. );
+
+	/*!
+	 * @brief destructor
+	 * @details stops the recording and waits for the thread
+	*/
+	~TomographyJob( void );
+
+	/*!
+	 * @brief deleted
+	*/
+	TomographyJob( const TomographyJob& ) = delete;
+
+	/*!
+	 * @brief deleted
+	*/
+	TomographyJob& operator=( const TomographyJob& ) = delete;
+
+	/*!
+	 * @brief request the recording to stop
+	*/
+	void Stop( void ){ progress_token_.RequestStop(); };
+
+	/*!
+	 * @brief check if the recording has finished
+	 * @return true when the thread finished
+	*/
+	bool finished( void ) const{ return finished_.load(); };
+
+	/*!
+	 * @brief get the tomography properties
+	 * @return properties
+	*/
+	const TomographyProperties& properties( void ) const{ return properties_; };
+
+	/*!
+	 * @brief get progress of the recording
+	 * @return token
+	*/
+	const ProgressToken& progress_token( void ) const{ return progress_token_; };
+
+	/*!
+	 * @brief get the partially recorded projections
+	 * @return preview
+	*/
+	const ProjectionsPreview& preview( void ) const{ return preview_; };
+
+	/*!
+	 * @brief get the recorded projections
+	 * @details only valid after the job has finished
+	 * @return projections when the recording was not stopped
+	*/
+	optional<Projections>& projections( void ){ return projections_; };
+
+	/*!
+	 * @brief get the split projections
+	 * @details only valid after the job has finished
+	 * @return spectral, simple, primary and scatter projections when enabled in properties
+	*/
+	vector<Projections>& split_projections( void ){ return split_projections_; };
+
+
+	private:
+
+	TomographyProperties properties_;						/*!< properties of tomography*/
+	ProjectionsProperties projections_properties_;	/*!< properties of projections*/
+	Gantry gantry_;															/*!< gantry of ct-device*/
+	const Model& model_;												/*!< model to slice*/
+	double z_position_;													/*!< z-position of slice*/
+
+	Tomography tomography_;											/*!< tomography*/
+	ProgressToken progress_token_;							/*!< token for progress and stop*/
+	ProjectionsPreview preview_;								/*!< partially recorded projections*/
+	optional<Projections> projections_;					/*!< recorded projections*/
+	vector<Projections> split_projections_;			/*!< recorded split projections*/
+	std::atomic<bool> finished_;								/*!< flag for finished thread*/
+
+	std::thread worker_;												/*!< thread running the recording. Started last*/
+
+};
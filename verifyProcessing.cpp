@@ -8,6 +8,9 @@
 #include "tomography.h"
 #include "projectionsProperties.h"
 #include "projections.h"
+#include "fanBeamProjections.h"
+#include "scanConfiguration.h"
+#include "programState.h"
 #include "filteredProjections.h"
 #include "backprojection.h"
 
@@ -173,3 +176,113 @@ void VerifyFilteredprojections( void ){
 	closeAxis( nofilt_backproj_axis );
 	VoxelData::SetArtefactImpactFactor( 10 );
 }
+
+
+void VerifyFanBeamReconstruction( void ){
+
+	[[maybe_unused]] volatile ProgramState& program_state = PROGRAM_STATE();
+
+	path model_path{ "./verification.model" };
+	PersistingObject<Model> model{ Model{}, model_path, true };
+	if( !model.was_loaded() ){
+		cerr << "Could not load " << model_path << endl;
+		return;
+	}
+
+	const Tuple3D center = PrimitiveVector3{ model.size() } / -2.;
+	model.coordinate_system()->SetPrimitive( PrimitiveCoordinateSystem{ PrimitiveVector3{ center }, PrimitiveVector3{ 1, 0, 0 }, PrimitiveVector3{ 0, 1, 0 }, PrimitiveVector3{ 0, 0, 1 } } );
+
+	// scan without scattering
+	ScanConfiguration configuration;
+	for( const auto& [ name, value ] : vector<pair<string, string>>{ { "number_of_angles", "60" }, { "number_of_distances", "40" }, 
+			{ "rays_per_pixel", "8" }, { "simulation_quality", "1" }, { "scattering", "0" } } )
+		configuration.Set( name, value );
+
+	simulation_properties = SimulationProperties{ configuration.tomography_properties.simulation_quality };
+	Gantry gantry = configuration.CreateGantry( GetCoordinateSystemTree().AddSystem( "Gantry system" ) );
+	configuration.tomography_properties.mean_energy_of_tube = gantry.tube().GetMeanEnergy();
+
+	const ProjectionsProperties& projections_properties = configuration.projections_properties;
+	Tomography tomography{ configuration.tomography_properties };
+
+	// parallel-beam reference
+	const Projections parallel_projections = tomography.RecordSlice( projections_properties, gantry, model, 0. ).value();
+	const Backprojection parallel_backprojection{ FilteredProjections{ parallel_projections, configuration.filter_type } };
+
+	// difference of two images relative to the reference's root mean square
+	const auto get_relative_difference = [ & ]( const Backprojection& backprojection ){
+		const DataGrid<> reference = parallel_backprojection.getGrid();
+		const DataGrid<> image = backprojection.getGrid();
+		double squared_difference = 0., squared_reference = 0.;
+		for( size_t c = 0; c < reference.size().c; c++ ){
+			for( size_t r = 0; r < reference.size().r; r++ ){
+				squared_difference += pow( image.GetData( GridIndex{ c, r } ) - reference.GetData( GridIndex{ c, r } ), 2. );
+				squared_reference += pow( reference.GetData( GridIndex{ c, r } ), 2. );
+			}
+		}
+		return sqrt( squared_difference / squared_reference );
+	};
+
+	// every sample lies on a line of the parallel grid and the weights of each line sum up to one
+	const auto check_weights = [ & ]( const FanBeamProjections& fan_beam_projections ){
+		const vector<vector<double>> weights = fan_beam_projections.GetRedundancyWeights();
+		vector<vector<double>> weight_sums( parallel_projections.size().c, vector<double>( parallel_projections.size().r, 0. ) );
+		double max_grid_error = 0.;
+		
+		for( size_t frame_index = 0; frame_index < fan_beam_projections.number_of_frames(); frame_index++ ){
+			for( size_t pixel_index = 0; pixel_index < fan_beam_projections.number_of_pixel(); pixel_index++ ){
+				const ProjectionsAssignment assignment = parallel_projections.GetAssignment( fan_beam_projections.GetRadonCoordinates( frame_index, pixel_index ) );
+				max_grid_error = std::max( { max_grid_error, std::abs( assignment.error.c ) / projections_properties.angles_resolution(), 
+																		 std::abs( assignment.error.r ) / projections_properties.distances_resolution() } );
+				weight_sums.at( assignment.index.c ).at( assignment.index.r ) += weights.at( frame_index ).at( pixel_index );
+			}
+		}
+
+		double max_sum_error = 0.;
+		for( const vector<double>& angle_weight_sums : weight_sums )
+			for( const double weight_sum : angle_weight_sums ) max_sum_error = std::max( max_sum_error, std::abs( weight_sum - 1. ) );
+
+		cout << "  max. distance of a sample to its grid point in resolutions: " << max_grid_error << endl;
+		cout << "  max. deviation of a line's weight sum from one: " << max_sum_error << endl;
+		return max_grid_error < 1E-6 && max_sum_error < 1E-9;
+	};
+
+	// fan-beam acquisition of a full rotation
+	const FanBeamProjections fan_beam_projections = tomography.RecordFanBeam( projections_properties, gantry, model, 0. ).value();
+	const Backprojection fan_beam_backprojection{ FilteredProjections{ fan_beam_projections, configuration.filter_type } };
+	
+	cout << "Full rotation with " << fan_beam_projections.number_of_frames() << " frames" << endl;
+	const bool are_full_rotation_weights_valid = check_weights( fan_beam_projections );
+	const double full_rotation_difference = get_relative_difference( fan_beam_backprojection );
+	cout << "  relative difference to parallel-beam reconstruction: " << full_rotation_difference << endl;
+	cout << "Full rotation: " << ( are_full_rotation_weights_valid && full_rotation_difference < .05 ? "passed" : "failed" ) << endl;
+
+	// parker weights of a sample and its conjugate sample sum up to one. The conjugate sample may lie before or after the sample
+	const double half_fan_angle = .3;
+	const double scan_angle = PI + 2. * half_fan_angle;
+	double max_parker_error = 0.;
+	
+	for( double fan_angle = -half_fan_angle; fan_angle <= half_fan_angle; fan_angle += half_fan_angle / 50. ){
+		for( double gantry_angle = 0.; gantry_angle <= scan_angle; gantry_angle += scan_angle / 500. ){
+			double weight_sum = FanBeamProjections::GetParkerWeight( gantry_angle, fan_angle, half_fan_angle );
+			for( const double conjugate_angle : { gantry_angle + PI + 2. * fan_angle, gantry_angle - PI + 2. * fan_angle } ){
+				if( conjugate_angle >= 0. && conjugate_angle <= scan_angle ) 
+					weight_sum += FanBeamProjections::GetParkerWeight( conjugate_angle, -fan_angle, half_fan_angle );
+			}
+			max_parker_error = std::max( max_parker_error, std::abs( weight_sum - 1. ) );
+		}
+	}
+	
+	cout << "Parker weights" << endl;
+	cout << "  max. deviation of conjugate weight sums from one: " << max_parker_error << endl;
+
+	// short scan of half a rotation and the fan angle
+	const FanBeamProjections short_scan_projections = tomography.RecordShortScan( projections_properties, gantry, model, 0. ).value();
+	const Backprojection short_scan_backprojection{ FilteredProjections{ short_scan_projections, configuration.filter_type } };
+	
+	cout << "Short scan with " << short_scan_projections.number_of_frames() << " frames" << endl;
+	const bool are_short_scan_weights_valid = check_weights( short_scan_projections );
+	const double short_scan_difference = get_relative_difference( short_scan_backprojection );
+	cout << "  relative difference to parallel-beam reconstruction: " << short_scan_difference << endl;
+	cout << "Short scan: " << ( max_parker_error < 1E-9 && are_short_scan_weights_valid && short_scan_difference < .05 ? "passed" : "failed" ) << endl;
+}
@@ -7,6 +7,9 @@
 #include "gantry.h"
 #include "tomography.h"
 #include "projectionsProperties.h"
+#include "projections.h"
+#include "scanConfiguration.h"
+#include "programState.h"
 
 #ifdef TRANSMISSION_TRACKING
 
@@ -556,4 +559,63 @@ void verifyRNG( void ){
 	addSingleObject( generator_axis, "Propability histogram", probabilities, "$p$;$p$ Generator;Dots", 2);
 	
 	closeAxis( generator_axis );
-}
\ No newline at end of file
+}
+
+void VerifyPrimaryTransportCache( void ){
+
+	[[maybe_unused]] volatile ProgramState& program_state = PROGRAM_STATE();
+
+	path model_path{ "./verification.model" };
+	PersistingObject<Model> model{ Model{}, model_path, true };
+	if( !model.was_loaded() ){
+		cerr << "Could not load " << model_path << endl;
+		return;
+	}
+
+	const Tuple3D center = PrimitiveVector3{ model.size() } / -2.;
+	model.coordinate_system()->SetPrimitive( PrimitiveCoordinateSystem{ PrimitiveVector3{ center }, PrimitiveVector3{ 1, 0, 0 }, PrimitiveVector3{ 0, 1, 0 }, PrimitiveVector3{ 0, 0, 1 } } );
+
+	// small scan with scatter kernels
+	ScanConfiguration configuration;
+	for( const auto& [ name, value ] : vector<pair<string, string>>{ { "number_of_angles", "12" }, { "number_of_distances", "40" }, 
+			{ "rays_per_pixel", "4" }, { "simulation_quality", "1" }, { "scattering", "1" }, { "max_scattering_occurrences", "1" }, { "scatter_kernel", "1" } } )
+		configuration.Set( name, value );
+
+	simulation_properties = SimulationProperties{ configuration.tomography_properties.simulation_quality };
+	Gantry gantry = configuration.CreateGantry( GetCoordinateSystemTree().AddSystem( "Gantry system" ) );
+	configuration.tomography_properties.mean_energy_of_tube = gantry.tube().GetMeanEnergy();
+
+	// only scattering parameters differ between the recordings
+	TomographyProperties first_properties = configuration.tomography_properties;
+	TomographyProperties second_properties = first_properties;
+	second_properties.scatter_propability_correction *= 4.;
+	second_properties.scattered_ray_absorption_factor /= 2.;
+	second_properties.max_scattering_occurrences = 2;
+
+	Tomography first_tomography{ first_properties };
+	Tomography second_tomography{ second_properties };
+	const optional<Projections> first_projections = first_tomography.RecordSlice( configuration.projections_properties, gantry, model, 0. );
+	const optional<Projections> second_projections = second_tomography.RecordSlice( configuration.projections_properties, gantry, model, 0. );
+
+	const bool is_transport_reused = !first_tomography.primary_transports().empty() && 
+		first_tomography.primary_transports() == second_tomography.primary_transports();
+
+	// the kernels are applied again to the reused transport
+	double max_difference = 0.;
+	const DataGrid<> first_data = first_projections.value().data();
+	const DataGrid<> second_data = second_projections.value().data();
+	for( size_t c = 0; c < first_data.size().c; c++ ){
+		for( size_t r = 0; r < first_data.size().r; r++ )
+			max_difference = std::max( max_difference, std::abs( first_data.GetData( GridIndex{ c, r } ) - second_data.GetData( GridIndex{ c, r } ) ) );
+	}
+
+	// traced scattering changes the primary rays' energies. Its transports are not cached
+	TomographyProperties traced_properties = second_properties;
+	traced_properties.scatter_kernel_mode = false;
+	Tomography traced_tomography{ traced_properties };
+	traced_tomography.RecordSlice( configuration.projections_properties, gantry, model, 0. );
+
+	cout << "Kernel mode transport reused: " << ( is_transport_reused ? "passed" : "failed" ) << endl;
+	cout << "Kernel mode scattering reapplied: " << ( max_difference > 0. ? "passed" : "failed" ) << " (max. difference " << max_difference << ")" << endl;
+	cout << "Traced scattering not cached: " << ( traced_tomography.primary_transports().empty() ? "passed" : "failed" ) << endl;
+}
@@ -3,4 +3,5 @@
 void VerifyTransmission( void );
 void VerifyHardening( void );
 void VerifyScattering( void );
-void verifyRNG( void );
\ No newline at end of file
+void verifyRNG( void );
+void VerifyPrimaryTransportCache( void );
\ No newline at end of file
@@ -1,3 +1,4 @@
 #pragma once
 
 void VerifyFilteredprojections( void );
+void VerifyFanBeamReconstruction( void );
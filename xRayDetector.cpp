@@ -26,7 +26,9 @@ XRayDetector::XRayDetector( CoordinateSystem* const coordinate_system,
 								const ProjectionsProperties projection_properties, 
 								const PhysicalDetectorProperties physical_properties ) :
 	coordinate_system_( coordinate_system ),
-	properties_{ projection_properties, physical_properties }
+	properties_{ projection_properties, physical_properties },
+	bounding_sphere_radius_( 0. ),
+	max_angle_to_middle_normal_( PI )
 {
 	// amount of distances or pixel
 	const size_t number_of_distances = properties_.number_of_pixel.c;		
@@ -151,6 +153,7 @@ XRayDetector::XRayDetector( CoordinateSystem* const coordinate_system,
 
 	// after constructing converted poixel are identical
 	converted_pixel_array_ = pixel_array_;
+	UpdateReachabilityBounds();
 }
 
 
@@ -259,4 +262,73 @@ void XRayDetector::ConvertPixelArray( const CoordinateSystem* const target_coord
 	for( size_t pixel_index = 0; pixel_index < pixel_array_.size(); pixel_index++ ){
 		converted_pixel_array_.at( pixel_index ) = std::move( pixel_array_.at( pixel_index ).ConvertTo( target_coordinate_system ) );
 	}
+
+	UpdateReachabilityBounds();
+}
+
+void XRayDetector::UpdateReachabilityBounds( void ){
+
+	if( converted_pixel_array_.empty() ) return;
+
+	const CoordinateSystem* const pixel_system = converted_pixel_array_.front().origin().GetCoordinateSystem();
+
+	// corners of all pixel
+	vector<Point3D> corners;
+	for( const DetectorPixel& pixel : converted_pixel_array_ ){
+		corners.push_back( pixel.GetPoint( pixel.parameter_1_min(), pixel.parameter_2_min() ) );
+		corners.push_back( pixel.GetPoint( pixel.parameter_1_min(), pixel.parameter_2_max() ) );
+		corners.push_back( pixel.GetPoint( pixel.parameter_1_max(), pixel.parameter_2_min() ) );
+		corners.push_back( pixel.GetPoint( pixel.parameter_1_max(), pixel.parameter_2_max() ) );
+	}
+
+	// center and radius of a sphere enclosing all corners
+	Vector3D corner_sum{ Tuple3D{ 0, 0, 0 }, pixel_system };
+	for( const Point3D& corner : corners ) corner_sum = corner_sum + corner;
+	bounding_sphere_center_ = Point3D{ corner_sum * ( 1. / static_cast<double>( corners.size() ) ) };
+
+	bounding_sphere_radius_ = 0.;
+	for( const Point3D& corner : corners )
+		bounding_sphere_radius_ = std::max( bounding_sphere_radius_, ( corner - bounding_sphere_center_ ).length() );
+
+	// mean normal. normals are oriented like the first pixel's normal
+	const Unitvector3D first_normal = converted_pixel_array_.front().GetNormal();
+	Vector3D normal_sum{ Tuple3D{ 0, 0, 0 }, pixel_system };
+	for( const DetectorPixel& pixel : converted_pixel_array_ ){
+		const Unitvector3D normal = pixel.GetNormal();
+		normal_sum = normal_sum + ( normal * first_normal >= 0. ? Vector3D{ normal } : -normal );
+	}
+	middle_pixel_normal_ = Unitvector3D{ normal_sum };
+
+	// largest angle between the lines of a pixel normal and the mean normal
+	max_angle_to_middle_normal_ = 0.;
+	for( const DetectorPixel& pixel : converted_pixel_array_ ){
+		const double angle = acos( ForceToMax( std::abs( pixel.GetNormal() * middle_pixel_normal_ ), 1. ) );
+		max_angle_to_middle_normal_ = std::max( max_angle_to_middle_normal_, angle );
+	}
+}
+
+bool XRayDetector::IsReachable( const Ray& ray ) const{
+
+	// ray must pass the bounding sphere in forward direction
+	const Vector3D origin_to_center = bounding_sphere_center_ - ray.origin();
+	const double center_distance_squared = pow( origin_to_center.length(), 2. );
+	const double radius_squared = pow( bounding_sphere_radius_, 2. );
+
+	if( center_distance_squared > radius_squared ){
+		const double closest_approach_parameter = origin_to_center * ray.direction();
+		if( closest_approach_parameter < 0. ) return false;
+		if( center_distance_squared - pow( closest_approach_parameter, 2. ) > radius_squared ) return false;
+	}
+
+	// angle to every pixel normal must be too large for the anti scattering structure
+	if( properties_.has_anti_scattering_structure ){
+		const double angle_to_middle_normal = 
+			acos( ForceToMax( std::abs( ray.direction() * middle_pixel_normal_ ), 1. ) );
+		
+		if( angle_to_middle_normal > 
+				max_angle_to_middle_normal_ + properties_.max_angle_allowed_by_structure + 1e-6 )
+			return false;
+	}
+
+	return true;
 }
\ No newline at end of file
@@ -48,6 +48,12 @@ class XRayDetector{
 	 * @return vector of pixels in one row
 	*/
 	vector<DetectorPixel> pixel_array( void ) const{ return pixel_array_; };
+
+	/*!
+	 * @brief get all detector pixel converted to the system given in ConvertPixelArray()
+	 * @return reference to converted pixel
+	*/
+	const vector<DetectorPixel>& converted_pixel_array( void ) const{ return converted_pixel_array_; };
 	
 	/*!
 	 * @brief get the physical parameters of detector
@@ -92,6 +98,15 @@ class XRayDetector{
 	 */
 	bool TryDetection( Ray& ray ) const;
 
+	/*!
+	 * @brief cheap conservative check whether a ray can reach the detector
+	 * @details tests the ray against a bounding sphere of the converted pixel and against the angles 
+	 * accepted by the anti scattering structure. A ray failing this test is never detected
+	 * @param ray ray in the coordinate system of the converted pixel
+	 * @return false when the ray can not hit any pixel
+	*/
+	bool IsReachable( const Ray& ray ) const;
+
 
 	private:
 
@@ -101,6 +116,17 @@ class XRayDetector{
 
 	DetectorProperties properties_;								/*!< properties*/
 
+	Point3D bounding_sphere_center_;							/*!< center of a sphere enclosing all converted pixel*/
+	double bounding_sphere_radius_;								/*!< radius of the sphere enclosing all converted pixel*/
+	Unitvector3D middle_pixel_normal_;						/*!< mean normal of all converted pixel*/
+	double max_angle_to_middle_normal_;						/*!< largest angle between a pixel normal and the mean normal*/
+
+
+	/*!
+	 * @brief update the bounds used in IsReachable() from the converted pixel
+	*/
+	void UpdateReachabilityBounds( void );
+
 	/*!
 	 * @brief get the index of the pixel which the ray will hit
 	 * @param ray ray to check
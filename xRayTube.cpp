@@ -168,12 +168,14 @@ void XRayTube::UpdateProperties( const XRayTubeProperties tube_properties ){
 }
 
 vector<Ray> XRayTube::GetEmittedBeam( const vector<DetectorPixel> detector_pixel, 
-																			const double detector_focus_distance ) const{
+																			const double detector_focus_distance,
+																			const vector<bool>& emitting_pixel ) const{
 
 	const size_t number_of_rays = properties_.number_of_rays_per_pixel_ * 
 																detector_pixel.size();
 
-	// split spectrum into the ray spectra
+	// split spectrum into the ray spectra. the split does not depend on the emitting pixel
+	// so that the rays' power is the same for all frames
 	const EnergySpectrum single_ray_spectrum = 
 		emitted_spectrum_.GetEvenlyScaled( 1. / static_cast<double>( number_of_rays ) );
 
@@ -185,6 +187,12 @@ vector<Ray> XRayTube::GetEmittedBeam( const vector<DetectorPixel> detector_pixel
 	// iterate all pixel
 	for( const DetectorPixel& current_pixel : detector_pixel ){
 		
+		// skip pixel which should not emit
+		if( !emitting_pixel.empty() && !emitting_pixel.at( pixel_index ) ){
+			pixel_index++;
+			continue;
+		}
+
 		// properties of created rays for this pixel
 		const RayProperties ray_properties{ single_ray_spectrum, pixel_index++, true };
 
@@ -129,9 +129,11 @@ class XRayTube{
 	 * @brief get beam created by tube
 	 * @param detector_pixel vector with all pixel
 	 * @param detector_focus_distance distance from pixel to focus (this tube)
+	 * @param emitting_pixel flags for the pixel whose rays are emitted. All pixel emit when empty
 	 * @return vector with rays in XY-plane of tube's coordinate system and parallel to pixel normals
 	*/
-	vector<Ray> GetEmittedBeam( const vector<DetectorPixel> detector_pixel, const double detector_focus_distance ) const;
+	vector<Ray> GetEmittedBeam( const vector<DetectorPixel> detector_pixel, const double detector_focus_distance, 
+															const vector<bool>& emitting_pixel = vector<bool>{} ) const;
 
 	/*!
 	 * @brief get coordinate system